@@ -0,0 +1,256 @@
+/*
+	cSerialWatcherBench.cpp
+
+	host benchmarks of cSerialWatcher, run them before and after a change to get a repeatable number
+	  - ns for each Update() and for each full frame, across slot counts and datatypes
+	  - bytes of a full frame, also of a realistic table in each tx mode (ascii, binary, compact binary)
+	  - rx commands parsed per second
+	  - ns and cpu cycles (x86) to format an integer, against the Print::printNumber() loop of the arduino core
+
+  Usage
+
+      cSerialWatcherBench       full run
+      cSerialWatcherBench -q    quick run (smoke test, the numbers are not meaningful)
+
+  The clock seen by the library (micros, millis) moves one SERIALWATCHER_TX_STREAM_PERIOD each Update(), so the frames
+  are sent back to back (one element each Update()), the timings are the real time spent in Update()
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "cSerialWatcher.h"
+#include "cSerialWatcherDecoder.h"
+#include "MockStream.h"
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <vector>
+
+static unsigned long Iterations = 200000;
+static const unsigned long Period = (SERIALWATCHER_TX_STREAM_PERIOD + 1) * 1000UL; //us
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static double NowNs() {
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//names of the slots, built once (F() strings on the host are plain pointers)
+static const char *SlotName(int k) {
+  static char names[SERIALWATCHER_TX_MAX_VALUES][16];
+  snprintf(names[k], sizeof(names[k]), "var%d", k);
+  return names[k];
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//Update() of a table of slots of one datatype, the values move at each loop
+template <typename T> static void BenchUpdate(const char *type, int slots, byte mode) {
+  MockStream S;
+  cSerialWatcher W(S);
+  std::vector<T> values(slots);
+  for (int k = 0; k < slots; k++) {
+    values[k] = (T)(k * 37 + 1);
+    W.Map(F(SlotName(k)), values[k]);
+  }
+  W.TxMode(mode);
+  for (int k = 0; k < 2000; k++) { //first stream (the mode is applied at the stream start)
+    W.Update();
+    ShimClock(Period);
+  }
+  S.Take();
+  unsigned long frames = 0;
+  double ns = 0;
+  for (unsigned long n = 0; n < Iterations; n++) {
+    values[n % slots] += (T)1;
+    double t0 = NowNs();
+    W.Update();
+    ns += NowNs() - t0;
+    ShimClock(Period);
+  }
+  if ((mode & SERIALWATCHER_TX_MODE_BINARY) == SERIALWATCHER_TX_MODE_BINARY) {
+    cSerialWatcherDecoder D;
+    D.Feed((const uint8_t *)S.Tx.data(), S.Tx.size(), [&](const cSerialWatcherRecord &Record) {
+      frames += Record.type == SERIALWATCHER_TX_BIN_RECORD_STREAM_END;
+    });
+  }
+  else {
+    for (size_t pos = 0; (pos = S.Tx.find("*>", pos)) != std::string::npos; pos++) {
+      frames++;
+    }
+  }
+  printf("%-8s %-6s %5d slots  %8.1f ns/update  %10.0f ns/frame  %6.0f bytes/frame\n", type, (mode & SERIALWATCHER_TX_MODE_BINARY) ? "binary" : "ascii",
+    slots, ns / Iterations, frames ? ns / frames : 0.0, frames ? (double)S.Tx.size() / frames : 0.0);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//bytes of a full frame of a realistic table: flags, small states, sensor readings, counters, floats, an adc array and a text
+static void BenchFrame(const char *name, byte mode) {
+  MockStream S;
+  cSerialWatcher W(S);
+  bool flags[4] = { true, false, false, true };
+  uint8_t states[6] = { 0, 1, 3, 2, 0, 7 };
+  int16_t sensors[6] = { 215, -40, 1023, 512, -3, 87 };
+  int32_t counters[4] = { 12, 4711, 100000, -250 };
+  uint32_t times[2] = { 123456, 3600000 };
+  float floats[6] = { 21.5f, -0.25f, 1013.2f, 0.0f, 3.14159f, 99.9f };
+  int16_t adc[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 512, 512, 512, 512, 0, 0, 0, 1 };
+  char text[12] = "running";
+  int k = 0;
+  for (bool &v : flags) { W.Map(F(SlotName(k++)), v); }
+  for (uint8_t &v : states) { W.Map(F(SlotName(k++)), v); }
+  for (int16_t &v : sensors) { W.Map(F(SlotName(k++)), v); }
+  for (int32_t &v : counters) { W.Map(F(SlotName(k++)), v); }
+  for (uint32_t &v : times) { W.Map(F(SlotName(k++)), v); }
+  for (float &v : floats) { W.Map(F(SlotName(k++)), v); }
+  W.Map(F(SlotName(k++)), adc);
+  W.Map(F(SlotName(k++)), text);
+  W.TxMode(mode);
+  for (int n = 0; n < 2000; n++) { //first stream (the mode is applied at the stream start)
+    W.Update();
+    ShimClock(Period);
+  }
+  S.Take();
+  for (unsigned long n = 0; n < Iterations / 10; n++) {
+    counters[1] += 1;
+    times[0] += 20;
+    W.Update();
+    ShimClock(Period);
+  }
+  unsigned long frames = 0;
+  if ((mode & SERIALWATCHER_TX_MODE_BINARY) == SERIALWATCHER_TX_MODE_BINARY) {
+    cSerialWatcherDecoder D;
+    D.Feed((const uint8_t *)S.Tx.data(), S.Tx.size(), [&](const cSerialWatcherRecord &Record) {
+      frames += Record.type == SERIALWATCHER_TX_BIN_RECORD_STREAM_END;
+    });
+  }
+  else {
+    for (size_t pos = 0; (pos = S.Tx.find("*>", pos)) != std::string::npos; pos++) {
+      frames++;
+    }
+  }
+  printf("frame %-15s %3d slots  %6.0f bytes/frame\n", name, k, frames ? (double)S.Tx.size() / frames : 0.0);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//rx commands parsed each second, commands = one or more commands of the same kind
+static void BenchRx(const char *name, const std::string &commands, byte result) {
+  MockStream S;
+  cSerialWatcher W(S);
+  int16_t i16 = 0;
+  uint32_t u32 = 0;
+  float f = 0;
+  uint64_t u64 = 0;
+  char txt[SERIALWATCHER_RX_ARRAY_LENGTH] = "";
+  W.Map(F("i16"), i16);
+  W.Map(F("u32"), u32);
+  W.Map(F("f"), f);
+  W.Map(F("u64"), u64);
+  W.Map(F("txt"), txt);
+  W.Update(); //the first Update() closes the map
+  S.Room = 0; //rx only
+  unsigned long count = 0;
+  double ns = 0;
+  size_t each = 0;
+  for (size_t pos = 0; (pos = commands.find('>', pos)) != std::string::npos; pos++) {
+    each++;
+  }
+  for (unsigned long n = 0; n < Iterations / 20; n++) {
+    S.Rx = commands;
+    S.RxPos = 0;
+    double t0 = NowNs();
+    while (S.available() > 0) {
+      W.Update();
+    }
+    ns += NowNs() - t0;
+    count += each;
+  }
+  printf("rx %-13s %8.1f ns/command  %10.0f commands/s  %6.1f MB/s  %s\n", name, ns / count, count * 1e9 / ns,
+    (double)commands.size() * (Iterations / 20) * 1e3 / ns, W.RxError() == result ? "" : "(unexpected result!)");
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static uint64_t Cycles() {
+  #if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+  #else
+  return 0; //not available, only ns
+  #endif
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//Print::printNumber() of the arduino core (base 10), one division for each digit, for comparison
+template <typename T> static byte PrintNumber(char *dst, const void *value) {
+  T n = *(const T *)value;
+  char buf[8 * sizeof(T) + 1];
+  char *str = &buf[sizeof(buf)];
+  do {
+    T m = n / 10;
+    *--str = '0' + (char)(n - 10 * m);
+    n = m;
+  } while (n);
+  byte k = (byte)(&buf[sizeof(buf)] - str);
+  memcpy(dst, str, k);
+  return k;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//formatting of integers of every digit count
+template <typename T> static void BenchFormat(const char *name, byte (*format)(char *dst, const void *value)) {
+  static const int count = 1024;
+  T values[count];
+  uint64_t x = 88172645463325252ull;
+  for (int k = 0; k < count; k++) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    values[k] = (T)(x >> (x % (8 * sizeof(T))));
+  }
+  char dst[32];
+  unsigned long chars = 0;
+  unsigned long rounds = Iterations / 200 + 1;
+  double t0 = NowNs();
+  uint64_t c0 = Cycles();
+  for (unsigned long n = 0; n < rounds; n++) {
+    for (int k = 0; k < count; k++) {
+      chars += format(dst, &values[k]);
+    }
+  }
+  uint64_t cycles = Cycles() - c0;
+  double ns = NowNs() - t0;
+  printf("format %-20s %6.1f ns/value  %6.1f cycles/value  (%lu chars)\n", name, ns / (rounds * count), (double)cycles / (rounds * count), chars);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+  if (argc > 1 && strcmp(argv[1], "-q") == 0) {
+    Iterations = 2000;
+  }
+  const int counts[] = { 1, 8, 32, SERIALWATCHER_TX_MAX_VALUES };
+  for (int slots : counts) {
+    BenchUpdate<uint8_t>("uint8_t", slots, SERIALWATCHER_TX_MODE_ASCII);
+    BenchUpdate<int16_t>("int16_t", slots, SERIALWATCHER_TX_MODE_ASCII);
+    BenchUpdate<int32_t>("int32_t", slots, SERIALWATCHER_TX_MODE_ASCII);
+    BenchUpdate<uint64_t>("uint64_t", slots, SERIALWATCHER_TX_MODE_ASCII);
+    BenchUpdate<float>("float", slots, SERIALWATCHER_TX_MODE_ASCII);
+    BenchUpdate<uint8_t>("uint8_t", slots, SERIALWATCHER_TX_MODE_BINARY);
+    BenchUpdate<int16_t>("int16_t", slots, SERIALWATCHER_TX_MODE_BINARY);
+    BenchUpdate<int32_t>("int32_t", slots, SERIALWATCHER_TX_MODE_BINARY);
+    BenchUpdate<uint64_t>("uint64_t", slots, SERIALWATCHER_TX_MODE_BINARY);
+    BenchUpdate<float>("float", slots, SERIALWATCHER_TX_MODE_BINARY);
+  }
+  BenchFrame("ascii", SERIALWATCHER_TX_MODE_ASCII);
+  BenchFrame("binary", SERIALWATCHER_TX_MODE_BINARY);
+  BenchFrame("binary compact", SERIALWATCHER_TX_MODE_BINARY | SERIALWATCHER_TX_MODE_COMPACT);
+  BenchFormat<uint32_t>("uint32_t", cSerialWatcherTraits<uint32_t>::codec.Format);
+  BenchFormat<uint32_t>("uint32_t printNumber", PrintNumber<uint32_t>);
+  BenchFormat<uint64_t>("uint64_t", cSerialWatcherTraits<uint64_t>::codec.Format);
+  BenchFormat<uint64_t>("uint64_t printNumber", PrintNumber<uint64_t>);
+  BenchFormat<int16_t>("int16_t", cSerialWatcherTraits<int16_t>::codec.Format);
+  BenchRx("int16_t", "<i\"0\"-12345>", SERIALWATCHER_RX_OK);
+  BenchRx("uint32_t", "<u\"1\"4000000000>", SERIALWATCHER_RX_OK);
+  BenchRx("float", "<f\"2\"-123.456>", SERIALWATCHER_RX_OK);
+  BenchRx("uint64_t", "<m\"3\"18446744073709551615>", SERIALWATCHER_RX_OK);
+  BenchRx("text", "<s\"4\"hello world>", SERIALWATCHER_RX_OK);
+  BenchRx("mixed", "<i\"0\"-12345><u\"1\"4000000000><f\"2\"-123.456><m\"3\"18446744073709551615><s\"4\"hello world>", SERIALWATCHER_RX_OK);
+  BenchRx("bad datatype", "<l\"0\"-12345>", SERIALWATCHER_RX_ERROR_DATATYPE);
+  BenchRx("bad value", "<i\"0\"99999>", SERIALWATCHER_RX_ERROR_VALUE);
+  BenchRx("overflow", "<s\"4\"0123456789012345678901234567890123456789>", SERIALWATCHER_RX_ERROR_OVERFLOW);
+  return 0;
+}
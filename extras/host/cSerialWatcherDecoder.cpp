@@ -0,0 +1,388 @@
+/*
+	cSerialWatcherDecoder.cpp
+
+	host side (pc) decoder of the cSerialWatcher binary tx records
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "cSerialWatcherDecoder.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//number of bytes of each datatype value, indexed by SERIALWATCHER_DATATYPE_* (0 = variable length)
+static const uint8_t DataTypeSize[16] = {1, 1, 1, 2, 2, 4, 4, 8, 8, 4, 1, 0, 0, 2, 2, 0};
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+cSerialWatcherDecoder::cSerialWatcherDecoder() { //constructor
+  _records = 0;
+  _errors = 0;
+  _schemaversion = -1;
+  _wide = false;
+  _compact = false;
+  _page = 0;
+  _pages = 0;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcherDecoder::Reset() {
+  _encoded.clear();
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcherDecoder::Feed(const uint8_t *data, size_t len, const Handler &handler) {
+  for (size_t n = 0; n < len; n++) {
+    if (data[n] != SERIALWATCHER_TX_BIN_DELIMITER) {
+      _encoded.push_back(data[n]);
+      continue;
+    }
+    //delimiter: a record is complete (empty records are ignored)
+    if (!_encoded.empty()) {
+      if (Decode()) {
+        _records += 1;
+        handler(_record);
+      }
+      else {
+        _errors += 1;
+      }
+      _encoded.clear();
+    }
+  }
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - COBS decoding and record validation -
+// each code byte tells the distance to the next (removed) zero, the zero implied by the last code is dropped
+//
+bool cSerialWatcherDecoder::Decode() {
+  _decoded.clear();
+  size_t k = 0;
+  while (k < _encoded.size()) {
+    uint8_t code = _encoded[k++];
+    for (uint8_t j = 1; j < code; j++) {
+      if (k >= _encoded.size()) {
+        return false; //truncated block
+      }
+      _decoded.push_back(_encoded[k++]);
+    }
+    if (code < 0xFF && k < _encoded.size()) {
+      _decoded.push_back(0);
+    }
+  }
+  // | type | length | payload | checksum |
+  if (_decoded.size() < 3 || _decoded[1] != _decoded.size() - 3) {
+    return false;
+  }
+  uint8_t sum = 0;
+  for (size_t n = 0; n < _decoded.size(); n++) {
+    sum += _decoded[n];
+  }
+  if (sum != 0) {
+    return false;
+  }
+  _record.type = _decoded[0];
+  _record.payload.assign(_decoded.begin() + 2, _decoded.end() - 1);
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// | slot | features | value length | value | name |
+// the slot is 2 bytes when the stream start has SERIALWATCHER_TX_BIN_FLAG_WIDE
+// SERIALWATCHER_DATATYPE_fixed16 has | scale | offset | (2 floats) before the name
+//
+bool cSerialWatcherDecoder::ParseElement(const cSerialWatcherRecord &Record, cSerialWatcherElement &Element, bool wide, bool compact) {
+  const std::vector<uint8_t> &p = Record.payload;
+  size_t n = wide ? 2 : 1; //slot bytes
+  if (Record.type != SERIALWATCHER_TX_BIN_RECORD_ELEMENT || p.size() < n + 2) {
+    return false;
+  }
+  Element.slot = wide ? (p[0] | (p[1] << 8)) : p[0];
+  Element.features = p[n];
+  size_t vlen = p[n + 1];
+  if (n + 2 + vlen > p.size()) {
+    return false;
+  }
+  Element.value.assign(p.begin() + n + 2, p.begin() + n + 2 + vlen);
+  size_t pos = n + 2 + vlen;
+  size_t used = ParseScale(p, pos, Element);
+  if ((Element.features & SERIALWATCHER_FEATURES_MASK_DATATYPE) == SERIALWATCHER_DATATYPE_fixed16 && used == 0) {
+    return false;
+  }
+  Element.name.assign(p.begin() + pos + used, p.end());
+  if (compact && vlen != 0 && !Unvarint(Element.value, Element.features & SERIALWATCHER_FEATURES_MASK_DATATYPE)) {
+    return false;
+  }
+  uint8_t size = DataTypeSize[Element.features & SERIALWATCHER_FEATURES_MASK_DATATYPE];
+  if (size != 0 && vlen != 0 && Element.value.size() != size) {
+    return false;
+  }
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Schema session -
+// the schema frame (stream start with SERIALWATCHER_TX_BIN_FLAG_SCHEMA) replaces the schema, | slot | features | name | records
+// the value frames carry the schema version, their | slot | value | records are dropped when the version does not match
+// an empty value of a numeric slot is an invalid value
+//
+bool cSerialWatcherDecoder::Parse(const cSerialWatcherRecord &Record, cSerialWatcherElement &Element) {
+  const std::vector<uint8_t> &p = Record.payload;
+  size_t n = _wide ? 2 : 1; //slot bytes
+  uint16_t slot = 0;
+  if (p.size() >= n) {
+    slot = _wide ? (p[0] | (p[1] << 8)) : p[0];
+  }
+  switch (Record.type) {
+    case SERIALWATCHER_TX_BIN_RECORD_STREAM_START:
+      _wide = p.size() >= 1 && (p[0] & SERIALWATCHER_TX_BIN_FLAG_WIDE) == SERIALWATCHER_TX_BIN_FLAG_WIDE;
+      _compact = p.size() >= 1 && (p[0] & SERIALWATCHER_TX_BIN_FLAG_COMPACT) == SERIALWATCHER_TX_BIN_FLAG_COMPACT;
+      if (p.size() >= 2 && (p[0] & SERIALWATCHER_TX_BIN_FLAG_SCHEMA) == SERIALWATCHER_TX_BIN_FLAG_SCHEMA) {
+        _schema.clear();
+        _schemaversion = p[1];
+      }
+      else if (p.size() >= 2 && (p[0] & SERIALWATCHER_TX_BIN_FLAG_VALUES) == SERIALWATCHER_TX_BIN_FLAG_VALUES && p[1] != _schemaversion) {
+        _schemaversion = -1; //schema frame lost, wait for the next one
+      }
+      return false;
+    case SERIALWATCHER_TX_BIN_RECORD_PAGE:
+      if (p.size() >= 4) {
+        _page = p[0] | (p[1] << 8);
+        _pages = p[2] | (p[3] << 8);
+      }
+      return false;
+    case SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT: {
+      if (p.size() < n + 1 || _schemaversion < 0) {
+        return false;
+      }
+      if (_schema.size() <= slot) {
+        cSerialWatcherElement Unknown;
+        Unknown.slot = 0xFFFF; //not received
+        Unknown.features = 0;
+        Unknown.scale = 1;
+        Unknown.offset = 0;
+        _schema.resize(slot + 1, Unknown);
+      }
+      Element.slot = slot;
+      Element.features = p[n];
+      Element.value.clear();
+      size_t used = ParseScale(p, n + 1, Element);
+      if ((Element.features & SERIALWATCHER_FEATURES_MASK_DATATYPE) == SERIALWATCHER_DATATYPE_fixed16 && used == 0) {
+        return false;
+      }
+      Element.name.assign(p.begin() + n + 1 + used, p.end());
+      _schema[slot] = Element;
+      return true;
+    }
+    case SERIALWATCHER_TX_BIN_RECORD_VALUE: {
+      if (p.size() < n || _schemaversion < 0 || slot >= _schema.size() || _schema[slot].slot != slot) {
+        return false;
+      }
+      Element = _schema[slot];
+      Element.value.assign(p.begin() + n, p.end());
+      if (_compact && !Element.value.empty() && !Unvarint(Element.value, Element.features & SERIALWATCHER_FEATURES_MASK_DATATYPE)) {
+        return false;
+      }
+      uint8_t size = DataTypeSize[Element.features & SERIALWATCHER_FEATURES_MASK_DATATYPE];
+      if (size != 0 && Element.value.empty()) {
+        Element.features |= SERIALWATCHER_FEATURES_MASK_INVALID_VALUE;
+      }
+      else if (size != 0 && Element.value.size() != size) {
+        return false;
+      }
+      return true;
+    }
+    default:
+      return ParseElement(Record, Element, _wide, _compact);
+  }
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// | sequence | lost | samples |
+// a gap in the sequence means a burst lost on the link, an increase of lost means samples dropped by the board (ring buffer full)
+//
+bool cSerialWatcherDecoder::ParseScope(const cSerialWatcherRecord &Record, cSerialWatcherScope &Scope) {
+  const std::vector<uint8_t> &p = Record.payload;
+  if (Record.type != SERIALWATCHER_TX_BIN_RECORD_SCOPE || p.size() < 4) {
+    return false;
+  }
+  Scope.sequence = p[0] | (p[1] << 8);
+  Scope.lost = p[2] | (p[3] << 8);
+  Scope.samples.assign(p.begin() + 4, p.end());
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// | slot | first index (2 bytes) | values |
+//
+bool cSerialWatcherDecoder::ParseArray(const cSerialWatcherRecord &Record, cSerialWatcherArray &Array, bool wide, bool compact) {
+  const std::vector<uint8_t> &p = Record.payload;
+  size_t n = wide ? 2 : 1; //slot bytes
+  if (Record.type != SERIALWATCHER_TX_BIN_RECORD_ARRAY || p.size() < n + 2) {
+    return false;
+  }
+  Array.slot = wide ? (p[0] | (p[1] << 8)) : p[0];
+  Array.first = p[n] | (p[n + 1] << 8);
+  Array.values.assign(p.begin() + n + 2, p.end());
+  return !compact || Unpack(Array.values);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+size_t cSerialWatcherDecoder::ParseScale(const std::vector<uint8_t> &p, size_t pos, cSerialWatcherElement &Element) {
+  Element.scale = 1;
+  Element.offset = 0;
+  if ((Element.features & SERIALWATCHER_FEATURES_MASK_DATATYPE) != SERIALWATCHER_DATATYPE_fixed16 || pos + 2 * sizeof(float) > p.size()) {
+    return 0;
+  }
+  memcpy(&Element.scale, &p[pos], sizeof(float)); //little-endian as the boards
+  memcpy(&Element.offset, &p[pos + sizeof(float)], sizeof(float));
+  return 2 * sizeof(float);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Compact values (SERIALWATCHER_TX_BIN_FLAG_COMPACT) -
+// integers: LEB128 varint, zigzag for the signed datatypes (fixed16 as int16_t), the other datatypes are raw
+//
+bool cSerialWatcherDecoder::Unvarint(std::vector<uint8_t> &value, uint8_t datatype) {
+  if (datatype == SERIALWATCHER_DATATYPE_fixed16) {
+    datatype = SERIALWATCHER_DATATYPE_int16_t;
+  }
+  uint8_t size = DataTypeSize[datatype];
+  if (datatype < SERIALWATCHER_DATATYPE_int8_t || datatype > SERIALWATCHER_DATATYPE_uint64_t) {
+    return true; //raw
+  }
+  uint64_t v = 0;
+  size_t k;
+  for (k = 0; k < value.size() && k < 10; k++) {
+    v |= (uint64_t)(value[k] & 0x7F) << (7 * k);
+    if ((value[k] & 0x80) == 0) {
+      break;
+    }
+  }
+  if (k + 1 != value.size()) {
+    return false; //unterminated or trailing bytes
+  }
+  if (datatype == SERIALWATCHER_DATATYPE_int8_t || datatype == SERIALWATCHER_DATATYPE_int16_t || 
+      datatype == SERIALWATCHER_DATATYPE_int32_t || datatype == SERIALWATCHER_DATATYPE_int64_t) {
+    v = (v >> 1) ^ (~(v & 1) + 1); //zigzag
+  }
+  value.resize(size);
+  for (k = 0; k < size; k++) {
+    value[k] = (uint8_t)(v >> (8 * k)); //little-endian
+  }
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// arrays: PackBits, n = 0 ... 127: n+1 literal bytes follow, n = -1 ... -127: the next byte repeated 1-n times
+//
+bool cSerialWatcherDecoder::Unpack(std::vector<uint8_t> &values) {
+  std::vector<uint8_t> raw;
+  size_t k = 0;
+  while (k < values.size()) {
+    int8_t n = (int8_t)values[k++];
+    if (n >= 0) {
+      if (k + n + 1 > values.size()) {
+        return false;
+      }
+      raw.insert(raw.end(), values.begin() + k, values.begin() + k + n + 1);
+      k += n + 1;
+    }
+    else if (n != -128 && k < values.size()) {
+      raw.insert(raw.end(), 1 - n, values[k++]);
+    }
+    else {
+      return false;
+    }
+  }
+  values.swap(raw);
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// | batch | result | writes |
+//
+bool cSerialWatcherDecoder::ParseAck(const cSerialWatcherRecord &Record, cSerialWatcherAck &Ack) {
+  const std::vector<uint8_t> &p = Record.payload;
+  if (Record.type != SERIALWATCHER_TX_BIN_RECORD_ACK || p.size() < 3) {
+    return false;
+  }
+  Ack.batch = p[0];
+  Ack.result = p[1];
+  Ack.writes = p[2];
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// | slot | state | features | value |
+// sent ahead of the element records, also out of the page or of the subscription, the value is always raw (also in compact mode)
+//
+bool cSerialWatcherDecoder::ParseAlarm(const cSerialWatcherRecord &Record, cSerialWatcherAlarm &Alarm, bool wide) {
+  const std::vector<uint8_t> &p = Record.payload;
+  size_t n = wide ? 2 : 1; //slot bytes
+  if (Record.type != SERIALWATCHER_TX_BIN_RECORD_ALARM || p.size() < n + 2) {
+    return false;
+  }
+  cSerialWatcherElement &Element = Alarm.Element;
+  Element.slot = wide ? (p[0] | (p[1] << 8)) : p[0];
+  Alarm.state = p[n];
+  Element.features = p[n + 1];
+  Element.value.assign(p.begin() + n + 2, p.end());
+  Element.name.clear();
+  Element.scale = 1;
+  Element.offset = 0;
+  uint8_t size = DataTypeSize[Element.features & SERIALWATCHER_FEATURES_MASK_DATATYPE];
+  return size != 0 && Element.value.size() == size;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+std::string cSerialWatcherDecoder::ValueToString(const cSerialWatcherElement &Element) {
+  const std::vector<uint8_t> &v = Element.value;
+  uint64_t raw = 0;
+  char buf[32];
+  if (v.empty()) {
+    return std::string();
+  }
+  uint8_t size = DataTypeSize[Element.features & SERIALWATCHER_FEATURES_MASK_DATATYPE];
+  if ((Element.features & SERIALWATCHER_FEATURES_MASK_ARRAY) == SERIALWATCHER_FEATURES_MASK_ARRAY && size != 0 && v.size() > size) {
+    std::string text;
+    cSerialWatcherElement One = Element;
+    One.features &= ~SERIALWATCHER_FEATURES_MASK_ARRAY;
+    for (size_t k = 0; k + size <= v.size(); k += size) {
+      One.value.assign(v.begin() + k, v.begin() + k + size);
+      text += (k == 0 ? "" : ",") + ValueToString(One);
+    }
+    return text;
+  }
+  for (size_t n = 0; n < v.size() && n < 8; n++) {
+    raw |= (uint64_t)v[n] << (8 * n); //little-endian
+  }
+  switch (Element.features & SERIALWATCHER_FEATURES_MASK_DATATYPE) {
+    case SERIALWATCHER_DATATYPE_bool:
+    case SERIALWATCHER_DATATYPE_uint8_t:
+    case SERIALWATCHER_DATATYPE_uint16_t:
+    case SERIALWATCHER_DATATYPE_uint32_t:
+    case SERIALWATCHER_DATATYPE_uint64_t:
+      snprintf(buf, sizeof(buf), "%llu", (unsigned long long)raw);
+      break;
+    case SERIALWATCHER_DATATYPE_int8_t:
+      snprintf(buf, sizeof(buf), "%d", (int)(int8_t)raw);
+      break;
+    case SERIALWATCHER_DATATYPE_int16_t:
+      snprintf(buf, sizeof(buf), "%d", (int)(int16_t)raw);
+      break;
+    case SERIALWATCHER_DATATYPE_int32_t:
+      snprintf(buf, sizeof(buf), "%ld", (long)(int32_t)raw);
+      break;
+    case SERIALWATCHER_DATATYPE_int64_t:
+      snprintf(buf, sizeof(buf), "%lld", (long long)(int64_t)raw);
+      break;
+    case SERIALWATCHER_DATATYPE_float: {
+      float f;
+      uint32_t r = (uint32_t)raw;
+      memcpy(&f, &r, sizeof(f));
+      snprintf(buf, sizeof(buf), "%.2f", f);
+      break;
+    }
+    case SERIALWATCHER_DATATYPE_half: {
+      int exp = (raw >> 10) & 0x1F;
+      double f = (exp == 0) ? ldexp((double)(raw & 0x3FF), -24) : ldexp((double)((raw & 0x3FF) | 0x400), exp - 25); //subnormal, normal
+      if (exp == 0x1F) {
+        f = (raw & 0x3FF) != 0 ? NAN : INFINITY;
+      }
+      snprintf(buf, sizeof(buf), "%.2f", (raw & 0x8000) != 0 ? -f : f);
+      break;
+    }
+    case SERIALWATCHER_DATATYPE_fixed16:
+      snprintf(buf, sizeof(buf), "%.2f", Element.offset + (int16_t)raw * Element.scale);
+      break;
+    default: //char, achar, flashstring
+      return std::string(v.begin(), v.end());
+  }
+  return std::string(buf);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,174 @@
+/*
+	cSerialWatcherDecoder.h
+
+	host side (pc) decoder of the cSerialWatcher binary tx records
+	it builds with any C++11 compiler and has no arduino dependencies, so the protocol can be tested on linux
+
+  Usage example
+
+      cSerialWatcherDecoder Decoder;
+      Decoder.Feed(buffer, length, [](const cSerialWatcherRecord &Record) {
+        cSerialWatcherElement Element;
+        if (cSerialWatcherDecoder::ParseElement(Record, Element)) {
+          // Element.slot, Element.features, Element.value, Element.name
+        }
+      });
+
+  With SERIALWATCHER_TX_MODE_SCHEMA the value records carry only the slot, use Parse() instead of ParseElement():
+  it keeps the names and features of the last schema frame and fills them in
+
+        if (Decoder.Parse(Record, Element)) { ... }
+
+  The numeric arrays (SERIALWATCHER_FEATURES_MASK_ARRAY) have an element record without value, followed by
+  SERIALWATCHER_TX_BIN_RECORD_ARRAY records with the values
+
+        cSerialWatcherArray Array;
+        if (cSerialWatcherDecoder::ParseArray(Record, Array, Decoder.Wide(), Decoder.Compact())) { ... }
+
+  The record layout is documented in src/cSerialWatcher.h (SERIALWATCHER_TX_BIN_*)
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef cSerialWatcherDecoder_h
+#define cSerialWatcherDecoder_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Tx binary records, same values of src/cSerialWatcher.h
+#define SERIALWATCHER_TX_BIN_DELIMITER 0x00
+#define SERIALWATCHER_TX_BIN_RECORD_STREAM_START 0x01
+#define SERIALWATCHER_TX_BIN_RECORD_STREAM_END 0x02
+#define SERIALWATCHER_TX_BIN_RECORD_ELEMENT 0x03
+#define SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT 0x04
+#define SERIALWATCHER_TX_BIN_RECORD_VALUE 0x05
+#define SERIALWATCHER_TX_BIN_RECORD_SCOPE 0x06
+#define SERIALWATCHER_TX_BIN_RECORD_PAGE 0x07
+#define SERIALWATCHER_TX_BIN_RECORD_ARRAY 0x08
+#define SERIALWATCHER_TX_BIN_RECORD_ACK 0x09
+#define SERIALWATCHER_TX_BIN_RECORD_ALARM 0x0A
+#define SERIALWATCHER_TX_BIN_FLAG_EXCEEDED_MAX_TXVAR 0x01
+#define SERIALWATCHER_TX_BIN_FLAG_DELTA 0x02
+#define SERIALWATCHER_TX_BIN_FLAG_SCHEMA 0x04
+#define SERIALWATCHER_TX_BIN_FLAG_VALUES 0x08
+#define SERIALWATCHER_TX_BIN_FLAG_WIDE 0x10
+#define SERIALWATCHER_TX_BIN_FLAG_COMPACT 0x20
+
+// Tx Datatypes encoding, same values of src/cSerialWatcher.h
+#define SERIALWATCHER_DATATYPE_bool 0
+#define SERIALWATCHER_DATATYPE_int8_t 1
+#define SERIALWATCHER_DATATYPE_uint8_t 2
+#define SERIALWATCHER_DATATYPE_int16_t 3
+#define SERIALWATCHER_DATATYPE_uint16_t 4
+#define SERIALWATCHER_DATATYPE_int32_t 5
+#define SERIALWATCHER_DATATYPE_uint32_t 6
+#define SERIALWATCHER_DATATYPE_int64_t 7
+#define SERIALWATCHER_DATATYPE_uint64_t 8
+#define SERIALWATCHER_DATATYPE_float 9
+#define SERIALWATCHER_DATATYPE_char 10
+#define SERIALWATCHER_DATATYPE_achar 11
+#define SERIALWATCHER_DATATYPE_flashstring 12
+#define SERIALWATCHER_DATATYPE_half 13 //float in half precision
+#define SERIALWATCHER_DATATYPE_fixed16 14 //float as int16_t fixed point, value = offset + integer * scale
+
+// Tx Array Features - BitMask, same values of src/cSerialWatcher.h
+#define SERIALWATCHER_FEATURES_MASK_DATATYPE 0x0F
+#define SERIALWATCHER_FEATURES_MASK_INVALID_NAME 0x10
+#define SERIALWATCHER_FEATURES_MASK_INVALID_VALUE 0x20
+#define SERIALWATCHER_FEATURES_MASK_READONLY 0x40
+#define SERIALWATCHER_FEATURES_MASK_ARRAY 0x80
+
+//one decoded record (COBS removed, length and checksum verified)
+struct cSerialWatcherRecord {
+  uint8_t type;
+  std::vector<uint8_t> payload;
+};
+
+//one decoded SERIALWATCHER_TX_BIN_RECORD_ELEMENT
+struct cSerialWatcherElement {
+  uint16_t slot;
+  uint8_t features;
+  std::vector<uint8_t> value; //raw little-endian value or text
+  std::string name;
+  float scale; //SERIALWATCHER_DATATYPE_fixed16 only (1 and 0 otherwise)
+  float offset;
+};
+
+//one decoded SERIALWATCHER_TX_BIN_RECORD_ARRAY
+struct cSerialWatcherArray {
+  uint16_t slot;
+  uint16_t first; //index of the first value of the record
+  std::vector<uint8_t> values; //raw little-endian values, the element record of the slot has the datatype
+};
+
+//one decoded SERIALWATCHER_TX_BIN_RECORD_ACK (batched writes)
+struct cSerialWatcherAck {
+  uint8_t batch; //counter of the batches received by the board
+  uint8_t result; //SERIALWATCHER_RX_OK (0) or the SERIALWATCHER_RX_ERROR_* code of src/cSerialWatcher.h
+  uint8_t writes; //number of variables written (0 with an error)
+};
+
+//one decoded SERIALWATCHER_TX_BIN_RECORD_ALARM (watch condition of a variable, see Alarm() in src/cSerialWatcher.h)
+struct cSerialWatcherAlarm {
+  uint8_t state; //1 = raised (or value changed), 0 = cleared
+  cSerialWatcherElement Element; //slot, features and raw value (no name)
+};
+
+//one decoded SERIALWATCHER_TX_BIN_RECORD_SCOPE
+struct cSerialWatcherScope {
+  uint16_t sequence; //number of the first sample of the burst
+  uint16_t lost; //samples dropped by the board since the scope start
+  std::vector<uint8_t> samples; //raw samples, the size of one sample is the sum of the sizes of the sampled slots
+};
+
+class cSerialWatcherDecoder {
+
+  // public methods
+  public:
+    typedef std::function<void(const cSerialWatcherRecord &Record)> Handler;
+    cSerialWatcherDecoder(); //constructor
+    void Feed(const uint8_t *data, size_t len, const Handler &handler); //decode a chunk of the stream, handler is called for each valid record
+    void Reset(); //drop the partially received record
+    static bool ParseElement(const cSerialWatcherRecord &Record, cSerialWatcherElement &Element, bool wide = false, bool compact = false); //wide = 2 bytes slot numbers, compact = varint integers
+    bool Parse(const cSerialWatcherRecord &Record, cSerialWatcherElement &Element); //as ParseElement(), plus the schema session, page and slot width records
+    uint16_t Page() const { return _page; } //page of the last paged stream
+    uint16_t Pages() const { return _pages; } //number of pages of the last paged stream
+    static bool ParseArray(const cSerialWatcherRecord &Record, cSerialWatcherArray &Array, bool wide = false, bool compact = false); //compact = packed values
+    bool Wide() const { return _wide; } //slot width of the last stream, for ParseArray()
+    bool Compact() const { return _compact; } //compact values in the last stream, for ParseArray()
+    static bool ParseAck(const cSerialWatcherRecord &Record, cSerialWatcherAck &Ack);
+    static bool ParseAlarm(const cSerialWatcherRecord &Record, cSerialWatcherAlarm &Alarm, bool wide = false); //wide = 2 bytes slot numbers
+    static bool ParseScope(const cSerialWatcherRecord &Record, cSerialWatcherScope &Scope);
+    static std::string ValueToString(const cSerialWatcherElement &Element); //value as printed by the ascii tx mode (comma separated for the numeric arrays)
+    uint32_t Records() const { return _records; } //number of valid records
+    uint32_t Errors() const { return _errors; } //number of discarded records (COBS, length or checksum errors)
+
+  // private methods
+  private:
+    static bool Unvarint(std::vector<uint8_t> &value, uint8_t datatype); //varint to raw little-endian value, true = valid
+    static bool Unpack(std::vector<uint8_t> &values); //PackBits to raw values, true = valid
+    static size_t ParseScale(const std::vector<uint8_t> &p, size_t pos, cSerialWatcherElement &Element); //fixed point scale and offset, returns the bytes used (0 = missing)
+
+  // private attributes
+  private:
+    std::vector<uint8_t> _encoded; //bytes received since the last delimiter
+    std::vector<uint8_t> _decoded;
+    cSerialWatcherRecord _record;
+    uint32_t _records;
+    uint32_t _errors;
+    std::vector<cSerialWatcherElement> _schema; //names and features of the last schema frame, indexed by slot
+    int _schemaversion; //-1 = no valid schema
+    bool _wide; //2 bytes slot numbers (SERIALWATCHER_TX_BIN_FLAG_WIDE)
+    bool _compact; //varint integers and packed arrays (SERIALWATCHER_TX_BIN_FLAG_COMPACT)
+    uint16_t _page;
+    uint16_t _pages;
+
+  //private methods
+  private:
+    bool Decode(); //true=valid record in _record
+};
+
+#endif
@@ -0,0 +1,146 @@
+/*
+	cSerialWatcherReplay.cpp
+
+	replay of a captured tx stream through cSerialWatcherStream, at full speed, and decoder benchmark
+	the capture is the raw bytes received from the board, any tx mode (or mode changes) included
+
+  Build (linux)
+
+      g++ -std=c++11 -O2 -o replay cSerialWatcherReplay.cpp cSerialWatcherStream.cpp cSerialWatcherDecoder.cpp
+
+  Capture
+
+      stty -F /dev/ttyACM0 115200 raw -echo && cat /dev/ttyACM0 > capture.bin
+
+  Usage
+
+      replay capture.bin             print every event
+      replay -t capture.bin          print the last value of each slot only
+      replay -c 1 capture.bin        feed chunks of 1 byte (default 64, a typical serial read)
+      replay -b 100 capture.bin      benchmark: decode the capture 100 times and report the decode speed
+
+  Run the benchmark on the same capture before and after a change of Tx() (and of the decoders): the decoded
+  updates must not change and the speed tells the cost of the protocol change on the pc side
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "cSerialWatcherStream.h"
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static bool ReadFile(const char *path, std::vector<uint8_t> &data) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    return false;
+  }
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    data.insert(data.end(), buf, buf + n);
+  }
+  fclose(f);
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void PrintEvent(const cSerialWatcherEvent &Event) {
+  const cSerialWatcherElement &Element = Event.Element;
+  const char *mode = Event.binary ? "bin" : "asc";
+  switch (Event.type) {
+    case SERIALWATCHER_TX_BIN_RECORD_STREAM_START:
+      printf("%s start flags 0x%02X\n", mode, Event.flags);
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_STREAM_END:
+      printf("%s end flags 0x%02X\n", mode, Event.flags);
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_ELEMENT:
+      printf("%s %u \"%s\" = %s%s (features 0x%02X)\n", mode, Element.slot, Element.name.c_str(), cSerialWatcherDecoder::ValueToString(Element).c_str(),
+             (Element.features & SERIALWATCHER_FEATURES_MASK_INVALID_VALUE) ? "(invalid)" : "", Element.features);
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT:
+      printf("%s %u \"%s\" schema (features 0x%02X)\n", mode, Element.slot, Element.name.c_str(), Element.features);
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_PAGE:
+      printf("%s page %u of %u\n", mode, Event.page, Event.pages);
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_ACK:
+      printf("%s ack batch %u result %u writes %u\n", mode, Event.Ack.batch, Event.Ack.result, Event.Ack.writes);
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_ALARM:
+      printf("%s alarm %u \"%s\" %s = %s\n", mode, Event.Alarm.Element.slot, Event.Alarm.Element.name.c_str(), Event.Alarm.state ? "raised" : "cleared",
+             cSerialWatcherDecoder::ValueToString(Event.Alarm.Element).c_str());
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_SCOPE:
+      printf("%s scope sequence %u lost %u, %u bytes\n", mode, Event.Scope.sequence, Event.Scope.lost, (unsigned)Event.Scope.samples.size());
+      break;
+  }
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+  size_t chunk = 64;
+  unsigned long repeat = 0; //0 = replay, >0 = benchmark
+  bool table = false;
+  const char *path = NULL;
+  for (int k = 1; k < argc; k++) {
+    if (strcmp(argv[k], "-c") == 0 && k + 1 < argc) {
+      chunk = strtoul(argv[++k], NULL, 10);
+    }
+    else if (strcmp(argv[k], "-b") == 0 && k + 1 < argc) {
+      repeat = strtoul(argv[++k], NULL, 10);
+    }
+    else if (strcmp(argv[k], "-t") == 0) {
+      table = true;
+    }
+    else {
+      path = argv[k];
+    }
+  }
+  std::vector<uint8_t> data;
+  if (path == NULL || chunk == 0 || !ReadFile(path, data)) {
+    fprintf(stderr, "usage: replay [-t] [-c chunk] [-b repeat] capture.bin\n");
+    return 1;
+  }
+  //replay
+  if (repeat == 0) {
+    cSerialWatcherStream Stream;
+    for (size_t pos = 0; pos < data.size(); pos += chunk) {
+      Stream.Feed(&data[pos], std::min(chunk, data.size() - pos), [&](const cSerialWatcherEvent &Event) {
+        if (!table) {
+          PrintEvent(Event);
+        }
+      });
+    }
+    if (table) {
+      for (size_t slot = 0; slot < Stream.Table().size(); slot++) {
+        const cSerialWatcherElement &Element = Stream.Table()[slot];
+        if (Element.slot == slot) {
+          printf("%u \"%s\" = %s\n", Element.slot, Element.name.c_str(), cSerialWatcherDecoder::ValueToString(Element).c_str());
+        }
+      }
+    }
+    printf("%u bytes, %u streams, %u updates, %u errors\n", (unsigned)data.size(), Stream.Streams(), Stream.Updates(), Stream.Errors());
+    return 0;
+  }
+  //benchmark: a new decoder for each pass, the events are counted only
+  uint64_t events = 0;
+  uint32_t updates = 0;
+  uint32_t errors = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (unsigned long r = 0; r < repeat; r++) {
+    cSerialWatcherStream Stream;
+    for (size_t pos = 0; pos < data.size(); pos += chunk) {
+      Stream.Feed(&data[pos], std::min(chunk, data.size() - pos), [&](const cSerialWatcherEvent &) {
+        events += 1;
+      });
+    }
+    updates = Stream.Updates();
+    errors = Stream.Errors();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double bytes = (double)data.size() * repeat;
+  printf("%u bytes x %lu: %.3f s, %.1f MB/s, %.2f M events/s (%u updates, %u errors each pass)\n",
+         (unsigned)data.size(), repeat, seconds, bytes / seconds / 1e6, events / seconds / 1e6, updates, errors);
+  return 0;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,573 @@
+/*
+	cSerialWatcherStream.cpp
+
+	host side (pc) decoder of the whole cSerialWatcher tx stream, ascii and binary, and encoder of the rx commands
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "cSerialWatcherStream.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//number of bytes of each datatype value, indexed by SERIALWATCHER_DATATYPE_* (0 = variable length)
+static const uint8_t DataTypeSize[16] = {1, 1, 1, 2, 2, 4, 4, 8, 8, 4, 1, 0, 0, 2, 2, 0};
+//rx DataType code of each datatype (0 = not writable), same values of src/cSerialWatcher.h (SERIALWATCHER_RX_CODE_STREAM_*)
+static const char RxCodes[16] = {'b', 'q', 'd', 'i', 'n', 'l', 'u', 'r', 'm', 'f', 'c', 's', 0, 'f', 'f', 0};
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+cSerialWatcherStream::cSerialWatcherStream() { //constructor
+  _streams = 0;
+  _updates = 0;
+  _errors = 0;
+  _frame = '\0';
+  _header = false;
+  _flags = 0;
+  _schemaversion = -1;
+  _array = false;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Decode a chunk of the stream -
+// each byte goes to the ascii frame decoder and to the binary record decoder, the one that doesn't match drops it
+// the binary decoder gets the bytes up to each delimiter, so the events keep the order of the stream,
+// and it is reset at the end of each ascii frame, so the first record after a switch to the binary mode is not lost
+//
+void cSerialWatcherStream::Feed(const uint8_t *data, size_t len, const Handler &handler) {
+  cSerialWatcherDecoder::Handler binary = [&](const cSerialWatcherRecord &Record) {
+    Binary(Record, handler);
+  };
+  size_t start = 0; //bytes not yet given to the binary decoder
+  for (size_t n = 0; n < len; n++) {
+    if (FeedAscii((char)data[n], handler)) {
+      _decoder.Reset();
+      start = n + 1;
+    }
+    else if (data[n] == SERIALWATCHER_TX_BIN_DELIMITER) {
+      _decoder.Feed(&data[start], n + 1 - start, binary);
+      start = n + 1;
+    }
+  }
+  _decoder.Feed(&data[start], len - start, binary);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Ascii frames -
+// <*slot"name"value"features; ... *> (<+ delta), <#version;slot"name"features; ... *>, <=version;slot"value; ... *> (<~ delta)
+// page @page"pages; and ack !batch"result"writes; right after the start, *1*; before the end when the table was too long
+//
+bool cSerialWatcherStream::FeedAscii(char c, const Handler &handler) {
+  cSerialWatcherEvent Event = cSerialWatcherEvent(); //all zero
+  if ((uint8_t)c < 0x20) { //not ascii text: binary record (its type is always a control char) or noise
+    _frame = '\0';
+    return false;
+  }
+  switch (_frame) {
+    //out of frame
+    case '\0':
+      if (c == SERIALWATCHER_ASCII_START) {
+        _frame = SERIALWATCHER_ASCII_START;
+      }
+      return false;
+    //frame type
+    case SERIALWATCHER_ASCII_START:
+      switch (c) {
+        case SERIALWATCHER_ASCII_STREAM:
+          break;
+        case SERIALWATCHER_ASCII_STREAM_DELTA:
+          Event.flags = SERIALWATCHER_TX_BIN_FLAG_DELTA;
+          break;
+        case SERIALWATCHER_ASCII_SCHEMA:
+          Event.flags = SERIALWATCHER_TX_BIN_FLAG_SCHEMA;
+          break;
+        case SERIALWATCHER_ASCII_VALUES:
+          Event.flags = SERIALWATCHER_TX_BIN_FLAG_VALUES;
+          break;
+        case SERIALWATCHER_ASCII_VALUES_DELTA:
+          Event.flags = SERIALWATCHER_TX_BIN_FLAG_VALUES | SERIALWATCHER_TX_BIN_FLAG_DELTA;
+          break;
+        default:
+          _frame = (c == SERIALWATCHER_ASCII_START) ? SERIALWATCHER_ASCII_START : '\0';
+          return false;
+      }
+      _frame = c;
+      _header = (c == SERIALWATCHER_ASCII_SCHEMA || c == SERIALWATCHER_ASCII_VALUES || c == SERIALWATCHER_ASCII_VALUES_DELTA);
+      _flags = 0;
+      _token.clear();
+      Event.type = SERIALWATCHER_TX_BIN_RECORD_STREAM_START;
+      Emit(Event, handler);
+      return false;
+    //elements
+    default:
+      if (c == SERIALWATCHER_ASCII_ELEMENT) {
+        AsciiToken(handler);
+        _token.clear();
+      }
+      else if (c == SERIALWATCHER_ASCII_END && _token.size() == 1 && _token[0] == SERIALWATCHER_ASCII_STREAM) {
+        _frame = '\0';
+        Event.type = SERIALWATCHER_TX_BIN_RECORD_STREAM_END;
+        Event.flags = _flags;
+        Emit(Event, handler);
+        return true;
+      }
+      else if (_token.size() < SERIALWATCHER_ASCII_TOKEN_MAX) {
+        _token += c;
+      }
+      else {
+        _errors += 1;
+        _frame = '\0';
+      }
+      return false;
+  }
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcherStream::AsciiToken(const Handler &handler) {
+  cSerialWatcherEvent Event = cSerialWatcherEvent(); //all zero
+  uint16_t slot;
+  uint16_t n;
+  //schema version
+  if (_header) {
+    _header = false;
+    if (!ParseNumber(_token, 0xFF, n)) {
+      _errors += 1;
+      _schemaversion = -1;
+    }
+    else if (_frame == SERIALWATCHER_ASCII_SCHEMA) {
+      _schema.clear();
+      _schemaversion = n;
+    }
+    else if (n != _schemaversion) {
+      _schemaversion = -1; //schema frame lost, wait for the next one
+    }
+    return;
+  }
+  if (_token == SERIALWATCHER_ASCII_EXCEEDED) {
+    _flags |= SERIALWATCHER_TX_BIN_FLAG_EXCEEDED_MAX_TXVAR;
+    return;
+  }
+  char code = _token.empty() ? '\0' : _token[0];
+  Split((code == SERIALWATCHER_ASCII_PAGE || code == SERIALWATCHER_ASCII_ACK || code == SERIALWATCHER_ASCII_ALARM) ? _token.substr(1) : _token, SERIALWATCHER_ASCII_FIELD, _fields);
+  //page
+  if (code == SERIALWATCHER_ASCII_PAGE) {
+    if (_fields.size() != 2 || !ParseNumber(_fields[0], 0xFFFF, Event.page) || !ParseNumber(_fields[1], 0xFFFF, Event.pages)) {
+      _errors += 1;
+      return;
+    }
+    Event.type = SERIALWATCHER_TX_BIN_RECORD_PAGE;
+    Emit(Event, handler);
+    return;
+  }
+  //batch acknowledge
+  if (code == SERIALWATCHER_ASCII_ACK) {
+    uint16_t batch, result, writes;
+    if (_fields.size() != 3 || !ParseNumber(_fields[0], 0xFF, batch) || !ParseNumber(_fields[1], 0xFF, result) || !ParseNumber(_fields[2], 0xFF, writes)) {
+      _errors += 1;
+      return;
+    }
+    Event.type = SERIALWATCHER_TX_BIN_RECORD_ACK;
+    Event.Ack.batch = (uint8_t)batch;
+    Event.Ack.result = (uint8_t)result;
+    Event.Ack.writes = (uint8_t)writes;
+    Emit(Event, handler);
+    return;
+  }
+  //alarm
+  if (code == SERIALWATCHER_ASCII_ALARM) {
+    uint16_t state;
+    cSerialWatcherElement &Element = Event.Alarm.Element;
+    if (_fields.size() != 4 || !ParseNumber(_fields[0], 0xFFFE, slot) || !ParseNumber(_fields[1], 1, state) || !ParseNumber(_fields[3], 0xFF, n) ||
+        !ParseValue(_fields[2], (uint8_t)n, Element.value)) {
+      _errors += 1;
+      return;
+    }
+    Event.type = SERIALWATCHER_TX_BIN_RECORD_ALARM;
+    Event.Alarm.state = (uint8_t)state;
+    Element.slot = slot;
+    Element.features = (uint8_t)n;
+    Element.scale = 1;
+    Element.offset = 0;
+    Emit(Event, handler);
+    return;
+  }
+  //element
+  if (_fields.empty() || !ParseNumber(_fields[0], 0xFFFE, slot)) {
+    _errors += 1;
+    return;
+  }
+  cSerialWatcherElement &Element = Event.Element;
+  Element.slot = slot;
+  Element.scale = 1;
+  Element.offset = 0;
+  switch (_frame) {
+    // slot"name"features
+    case SERIALWATCHER_ASCII_SCHEMA:
+      if (_fields.size() != 3 || !ParseNumber(_fields[2], 0xFF, n) || _schemaversion < 0) {
+        _errors += 1;
+        return;
+      }
+      Element.name = _fields[1];
+      Element.features = (uint8_t)n;
+      if (_schema.size() <= slot) {
+        cSerialWatcherElement Unknown;
+        Unknown.slot = 0xFFFF; //not received
+        Unknown.features = 0;
+        Unknown.scale = 1;
+        Unknown.offset = 0;
+        _schema.resize(slot + 1, Unknown);
+      }
+      _schema[slot] = Element;
+      Event.type = SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT;
+      break;
+    // slot"value or slot (invalid value)
+    case SERIALWATCHER_ASCII_VALUES:
+    case SERIALWATCHER_ASCII_VALUES_DELTA:
+      if (_fields.size() > 2 || _schemaversion < 0 || slot >= _schema.size() || _schema[slot].slot != slot) {
+        _errors += 1;
+        return;
+      }
+      Element = _schema[slot];
+      if (_fields.size() == 1) {
+        Element.features |= SERIALWATCHER_FEATURES_MASK_INVALID_VALUE;
+      }
+      else if (!ParseValue(_fields[1], Element.features, Element.value)) {
+        _errors += 1;
+        return;
+      }
+      Event.type = SERIALWATCHER_TX_BIN_RECORD_ELEMENT;
+      break;
+    // slot"name"value"features
+    default:
+      if (_fields.size() != 4 || !ParseNumber(_fields[3], 0xFF, n)) {
+        _errors += 1;
+        return;
+      }
+      Element.name = _fields[1];
+      Element.features = (uint8_t)n;
+      if ((Element.features & SERIALWATCHER_FEATURES_MASK_INVALID_VALUE) != SERIALWATCHER_FEATURES_MASK_INVALID_VALUE &&
+          !ParseValue(_fields[2], Element.features, Element.value)) {
+        _errors += 1;
+        return;
+      }
+      Event.type = SERIALWATCHER_TX_BIN_RECORD_ELEMENT;
+      break;
+  }
+  Emit(Event, handler);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Binary records -
+// the element (or value) record of a numeric array has no value, its values follow in array records until the next record of another type
+//
+void cSerialWatcherStream::Binary(const cSerialWatcherRecord &Record, const Handler &handler) {
+  cSerialWatcherEvent Event = cSerialWatcherEvent(); //all zero
+  Event.binary = true;
+  if (_array && Record.type != SERIALWATCHER_TX_BIN_RECORD_ARRAY) {
+    ArrayEnd(handler);
+  }
+  Event.type = Record.type;
+  switch (Record.type) {
+    case SERIALWATCHER_TX_BIN_RECORD_STREAM_START:
+    case SERIALWATCHER_TX_BIN_RECORD_STREAM_END:
+      _decoder.Parse(Record, Event.Element); //slot width, compact values and schema version
+      Event.flags = Record.payload.empty() ? 0 : Record.payload[0];
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_PAGE:
+      _decoder.Parse(Record, Event.Element);
+      Event.page = _decoder.Page();
+      Event.pages = _decoder.Pages();
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_ELEMENT:
+    case SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT:
+    case SERIALWATCHER_TX_BIN_RECORD_VALUE:
+      if (!_decoder.Parse(Record, Event.Element)) {
+        _errors += 1;
+        return;
+      }
+      if (Record.type != SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT) {
+        Event.type = SERIALWATCHER_TX_BIN_RECORD_ELEMENT;
+        if ((Event.Element.features & SERIALWATCHER_FEATURES_MASK_ARRAY) == SERIALWATCHER_FEATURES_MASK_ARRAY) {
+          Event.Element.features &= ~SERIALWATCHER_FEATURES_MASK_INVALID_VALUE; //no value in the record, the values follow
+          Event.Element.value.clear();
+          _arrayevent = Event;
+          _array = true;
+          return;
+        }
+      }
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_ARRAY: {
+      cSerialWatcherArray Array;
+      if (!cSerialWatcherDecoder::ParseArray(Record, Array, _decoder.Wide(), _decoder.Compact())) {
+        _errors += 1;
+        return;
+      }
+      if (_array && (Array.slot != _arrayevent.Element.slot || (Array.first == 0 && !_arrayevent.Element.value.empty()))) {
+        ArrayEnd(handler); //next array of a value frame
+      }
+      if (!_array) { //value frame: no element record, the slot comes from the schema frame
+        if (Array.first != 0 || Array.slot >= _table.size() || _table[Array.slot].slot != Array.slot ||
+            (_table[Array.slot].features & SERIALWATCHER_FEATURES_MASK_ARRAY) != SERIALWATCHER_FEATURES_MASK_ARRAY) {
+          _errors += 1;
+          return;
+        }
+        _arrayevent = Event;
+        _arrayevent.type = SERIALWATCHER_TX_BIN_RECORD_ELEMENT;
+        _arrayevent.Element = _table[Array.slot];
+        _arrayevent.Element.features &= ~SERIALWATCHER_FEATURES_MASK_INVALID_VALUE;
+        _arrayevent.Element.value.clear();
+        _array = true;
+      }
+      if ((size_t)Array.first * DataTypeSize[_arrayevent.Element.features & SERIALWATCHER_FEATURES_MASK_DATATYPE] != _arrayevent.Element.value.size()) {
+        _errors += 1; //array record lost
+        _array = false;
+        return;
+      }
+      _arrayevent.Element.value.insert(_arrayevent.Element.value.end(), Array.values.begin(), Array.values.end());
+      return;
+    }
+    case SERIALWATCHER_TX_BIN_RECORD_ACK:
+      if (!cSerialWatcherDecoder::ParseAck(Record, Event.Ack)) {
+        _errors += 1;
+        return;
+      }
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_SCOPE:
+      if (!cSerialWatcherDecoder::ParseScope(Record, Event.Scope)) {
+        _errors += 1;
+        return;
+      }
+      break;
+    case SERIALWATCHER_TX_BIN_RECORD_ALARM:
+      if (!cSerialWatcherDecoder::ParseAlarm(Record, Event.Alarm, _decoder.Wide())) {
+        _errors += 1;
+        return;
+      }
+      break;
+    default:
+      return; //unknown record, newer board
+  }
+  Emit(Event, handler);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcherStream::ArrayEnd(const Handler &handler) {
+  _array = false;
+  Emit(_arrayevent, handler);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcherStream::Emit(cSerialWatcherEvent &Event, const Handler &handler) {
+  if (Event.type == SERIALWATCHER_TX_BIN_RECORD_ELEMENT || Event.type == SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT) {
+    uint16_t slot = Event.Element.slot;
+    if (_table.size() <= slot) {
+      cSerialWatcherElement Unknown;
+      Unknown.slot = 0xFFFF; //not received
+      Unknown.features = 0;
+      Unknown.scale = 1;
+      Unknown.offset = 0;
+      _table.resize(slot + 1, Unknown);
+    }
+    _table[slot] = Event.Element;
+    _updates += (Event.type == SERIALWATCHER_TX_BIN_RECORD_ELEMENT) ? 1 : 0;
+  }
+  else if (Event.type == SERIALWATCHER_TX_BIN_RECORD_STREAM_END) {
+    _streams += 1;
+  }
+  else if (Event.type == SERIALWATCHER_TX_BIN_RECORD_ALARM) {
+    uint16_t slot = Event.Alarm.Element.slot;
+    if (slot < _table.size() && _table[slot].slot == slot) {
+      Event.Alarm.Element.name = _table[slot].name;
+    }
+  }
+  handler(Event);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Ascii value to raw little-endian value -
+// numbers as sent by the board (integers, floats with 2 decimals, nan, inf, ovf), numeric arrays comma separated, texts unchanged
+//
+bool cSerialWatcherStream::ParseValue(const std::string &text, uint8_t features, std::vector<uint8_t> &value) {
+  uint8_t datatype = features & SERIALWATCHER_FEATURES_MASK_DATATYPE;
+  uint8_t size = DataTypeSize[datatype];
+  value.clear();
+  if (datatype == SERIALWATCHER_DATATYPE_char || datatype == SERIALWATCHER_DATATYPE_achar || datatype == SERIALWATCHER_DATATYPE_flashstring) {
+    value.assign(text.begin(), text.end());
+    return datatype != SERIALWATCHER_DATATYPE_char || text.size() <= 1;
+  }
+  if (size == 0 || datatype > SERIALWATCHER_DATATYPE_float) {
+    return false; //binary stream only
+  }
+  size_t pos = 0;
+  while (true) {
+    size_t end = text.find(SERIALWATCHER_ASCII_VALUE, pos);
+    if (end == std::string::npos) {
+      end = text.size();
+    }
+    else if ((features & SERIALWATCHER_FEATURES_MASK_ARRAY) != SERIALWATCHER_FEATURES_MASK_ARRAY) {
+      return false; //more values for a single variable
+    }
+    const char *p = text.c_str() + pos;
+    const char *last = text.c_str() + end;
+    uint64_t raw = 0;
+    if (datatype == SERIALWATCHER_DATATYPE_float) {
+      float f;
+      if (end - pos == 3 && (memcmp(p, "nan", 3) == 0 || memcmp(p, "ovf", 3) == 0)) {
+        f = NAN; //out of the range printed by the board
+      }
+      else if (end - pos == 3 && memcmp(p, "inf", 3) == 0) {
+        f = INFINITY;
+      }
+      else {
+        char *stop;
+        f = strtof(p, &stop);
+        if (stop != last || p == last) {
+          return false;
+        }
+      }
+      uint32_t r;
+      memcpy(&r, &f, sizeof(r));
+      raw = r;
+    }
+    else {
+      bool sign = (datatype == SERIALWATCHER_DATATYPE_int8_t || datatype == SERIALWATCHER_DATATYPE_int16_t ||
+                   datatype == SERIALWATCHER_DATATYPE_int32_t || datatype == SERIALWATCHER_DATATYPE_int64_t);
+      bool negative = sign && p < last && *p == '-';
+      p += negative ? 1 : 0;
+      if (p == last) {
+        return false;
+      }
+      for (; p < last; p++) {
+        if (*p < '0' || *p > '9' || raw > (UINT64_MAX - (*p - '0')) / 10) {
+          return false;
+        }
+        raw = raw * 10 + (*p - '0');
+      }
+      uint64_t max = (size == 8) ? UINT64_MAX : ((uint64_t)1 << (size * 8)) - 1;
+      if (datatype == SERIALWATCHER_DATATYPE_bool) {
+        max = 1;
+      }
+      if (sign) {
+        max >>= 1; //positive range, the negative one has one more value
+        if (raw > max + (negative ? 1 : 0)) {
+          return false;
+        }
+        raw = negative ? (uint64_t)0 - raw : raw;
+      }
+      else if (raw > max) {
+        return false;
+      }
+    }
+    for (uint8_t k = 0; k < size; k++) {
+      value.push_back((uint8_t)(raw >> (8 * k))); //little-endian
+    }
+    if (end == text.size()) {
+      return true;
+    }
+    pos = end + 1;
+  }
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool cSerialWatcherStream::ParseNumber(const std::string &text, uint16_t max, uint16_t &val) {
+  uint32_t v = 0;
+  if (text.empty() || text.size() > 5) {
+    return false;
+  }
+  for (size_t k = 0; k < text.size(); k++) {
+    if (text[k] < '0' || text[k] > '9') {
+      return false;
+    }
+    v = v * 10 + (text[k] - '0');
+  }
+  if (v > max) {
+    return false;
+  }
+  val = (uint16_t)v;
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcherStream::Split(const std::string &text, char separator, std::vector<std::string> &fields) {
+  size_t pos = 0;
+  fields.clear();
+  while (true) {
+    size_t end = text.find(separator, pos);
+    if (end == std::string::npos) {
+      fields.push_back(text.substr(pos));
+      return;
+    }
+    fields.push_back(text.substr(pos, end - pos));
+    pos = end + 1;
+  }
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Rx commands -
+// <DataType"ArrayPlace"Value>, for example <i"3"-12>, <f"4"0.5>, <i"5"2:10,11> (numeric array from index 2), <p"0"1> (tx mode)
+//
+std::string cSerialWatcherCommand::Command(char code, uint32_t place, const std::string &value) {
+  std::string command(1, '<');
+  command += code;
+  command += '"';
+  command += std::to_string(place);
+  command += '"';
+  command += value;
+  command += '>';
+  return command;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+std::string cSerialWatcherCommand::Write(uint16_t slot, uint8_t datatype, const std::string &value) {
+  char code = RxCodes[datatype & SERIALWATCHER_FEATURES_MASK_DATATYPE];
+  if (code == 0) {
+    return std::string(); //readonly datatype
+  }
+  return Command(code, slot, value);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//<i"3"10|f"4"0.5|...>
+std::string cSerialWatcherCommand::Batch(const std::vector<std::string> &writes) {
+  std::string command(1, '<');
+  for (size_t k = 0; k < writes.size(); k++) {
+    if (writes[k].size() < 2) {
+      continue;
+    }
+    if (command.size() > 1) {
+      command += '|';
+    }
+    command.append(writes[k], 1, writes[k].size() - 2); //without < and >
+  }
+  command += '>';
+  return command;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+std::string cSerialWatcherCommand::TxMode(uint8_t mode) {
+  return Command('p', 0, std::to_string(mode));
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+std::string cSerialWatcherCommand::Schema() {
+  return Command('h', 0, "0");
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+std::string cSerialWatcherCommand::Page(uint16_t size, uint16_t page) {
+  return Command('g', size, std::to_string(page));
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+std::string cSerialWatcherCommand::Scope(uint8_t decimation, const std::vector<uint16_t> &slots) {
+  std::string list;
+  for (size_t k = 0; k < slots.size(); k++) {
+    list += (k == 0 ? "" : ",") + std::to_string(slots[k]);
+  }
+  return Command('o', decimation, list.empty() ? "0" : list);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+std::string cSerialWatcherCommand::Subscribe(uint8_t op, uint16_t first, uint16_t last) {
+  return Command('k', op, (first == last) ? std::to_string(first) : std::to_string(first) + "-" + std::to_string(last));
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//<K"0"FF0F...>, up to 12 bytes (96 slots) for each command, so the value fits the rx buffer of the board
+std::vector<std::string> cSerialWatcherCommand::Subscribe(const std::vector<bool> &slots) {
+  static const char Hex[] = "0123456789ABCDEF";
+  std::vector<std::string> commands;
+  for (size_t first = 0; first < slots.size(); first += 96) {
+    std::string bitmap;
+    for (size_t n = first; n < first + 96 && n < slots.size(); n += 8) {
+      uint8_t bits = 0;
+      for (size_t k = 0; k < 8 && n + k < slots.size(); k++) {
+        bits |= slots[n + k] ? (uint8_t)(1 << k) : 0;
+      }
+      bitmap += Hex[bits >> 4];
+      bitmap += Hex[bits & 0x0F];
+    }
+    commands.push_back(Command('K', (uint32_t)first, bitmap));
+  }
+  return commands;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,138 @@
+/*
+	cSerialWatcherStream.h
+
+	host side (pc) decoder of the whole cSerialWatcher tx stream, ascii and binary, and encoder of the rx commands
+	it builds with any C++11 compiler and has no arduino dependencies (see cSerialWatcherDecoder.h for the binary records)
+
+  Usage example
+
+      cSerialWatcherStream Stream;
+      Stream.Feed(buffer, length, [](const cSerialWatcherEvent &Event) {
+        if (Event.type == SERIALWATCHER_TX_BIN_RECORD_ELEMENT) {
+          // Event.Element.slot, Event.Element.name, cSerialWatcherDecoder::ValueToString(Event.Element)
+        }
+      });
+      std::string command = cSerialWatcherCommand::Write(3, SERIALWATCHER_DATATYPE_int16_t, "-12"); // <i"3"-12>
+
+  The ascii frames are decoded into the same events of the binary records: stream start and end (with the same flags),
+  page, ack and one SERIALWATCHER_TX_BIN_RECORD_ELEMENT for each slot update, with the value converted to raw little-endian bytes.
+  The schema session (both modes) fills in names and features of the value frames, the numeric arrays of the binary mode
+  are reassembled from their SERIALWATCHER_TX_BIN_RECORD_ARRAY records, so each array is one event.
+  The tx mode can change at any stream: every byte goes to both decoders, an ascii frame is dropped at the first control char
+  (each binary record has one), the binary records are checked by their checksum and the binary decoder restarts at each ascii frame end.
+
+  Table() keeps the last update of each slot.
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef cSerialWatcherStream_h
+#define cSerialWatcherStream_h
+
+#include "cSerialWatcherDecoder.h"
+
+// Ascii frames, same codes of src/cSerialWatcher.h (SERIALWATCHER_TX_CODE_*)
+#define SERIALWATCHER_ASCII_START '<'
+#define SERIALWATCHER_ASCII_STREAM '*' // <* full stream
+#define SERIALWATCHER_ASCII_STREAM_DELTA '+' // <+ delta stream
+#define SERIALWATCHER_ASCII_SCHEMA '#' // <#version; schema frame
+#define SERIALWATCHER_ASCII_VALUES '=' // <=version; value frame
+#define SERIALWATCHER_ASCII_VALUES_DELTA '~' // <~version; delta value frame
+#define SERIALWATCHER_ASCII_END '>' // *> stream end
+#define SERIALWATCHER_ASCII_PAGE '@' // @page"pages;
+#define SERIALWATCHER_ASCII_ACK '!' // !batch"result"writes;
+#define SERIALWATCHER_ASCII_ALARM '^' // ^slot"state"value"features;
+#define SERIALWATCHER_ASCII_FIELD '"'
+#define SERIALWATCHER_ASCII_ELEMENT ';'
+#define SERIALWATCHER_ASCII_VALUE ','
+#define SERIALWATCHER_ASCII_EXCEEDED "*1*"
+#define SERIALWATCHER_ASCII_TOKEN_MAX 4096 //longest ascii element, a longer one is dropped
+
+// Tx modes, same values of src/cSerialWatcher.h (see cSerialWatcherCommand::TxMode())
+#define SERIALWATCHER_TX_MODE_ASCII 0x00
+#define SERIALWATCHER_TX_MODE_BINARY 0x01
+#define SERIALWATCHER_TX_MODE_DELTA 0x02
+#define SERIALWATCHER_TX_MODE_SCHEMA 0x04
+#define SERIALWATCHER_TX_MODE_COMPACT 0x08
+
+// Subscription commands, same values of src/cSerialWatcher.h (see cSerialWatcherCommand::Subscribe())
+#define SERIALWATCHER_SUBSCRIBE_REPLACE 0
+#define SERIALWATCHER_SUBSCRIBE_ADD 1
+#define SERIALWATCHER_SUBSCRIBE_REMOVE 2
+
+//one event of the tx stream, type = SERIALWATCHER_TX_BIN_RECORD_*
+//STREAM_START, STREAM_END (flags), ELEMENT (slot update), SCHEMA_ELEMENT (name and features only), PAGE (page, pages), ACK, SCOPE, ALARM
+struct cSerialWatcherEvent {
+  uint8_t type;
+  uint8_t flags; //SERIALWATCHER_TX_BIN_FLAG_*
+  bool binary; //decoded from a binary record
+  uint16_t page;
+  uint16_t pages;
+  cSerialWatcherElement Element;
+  cSerialWatcherAck Ack;
+  cSerialWatcherScope Scope;
+  cSerialWatcherAlarm Alarm; //the name comes from the table, the alarm is not a slot update
+};
+
+class cSerialWatcherStream {
+
+  // public methods
+  public:
+    typedef std::function<void(const cSerialWatcherEvent &Event)> Handler;
+    cSerialWatcherStream(); //constructor
+    void Feed(const uint8_t *data, size_t len, const Handler &handler); //decode a chunk of the stream, handler is called for each event
+    const std::vector<cSerialWatcherElement> &Table() const { return _table; } //last update of each slot, indexed by slot (slot = 0xFFFF: not received)
+    uint32_t Streams() const { return _streams; } //number of stream ends
+    uint32_t Updates() const { return _updates; } //number of slot updates
+    uint32_t Errors() const { return _errors + _decoder.Errors(); } //discarded ascii elements and binary records
+    static bool ParseValue(const std::string &text, uint8_t features, std::vector<uint8_t> &value); //ascii value to raw little-endian value, true = valid
+
+  // private methods
+  private:
+    bool FeedAscii(char c, const Handler &handler); //true = end of an ascii frame
+    void AsciiToken(const Handler &handler); //one ascii element (or header) complete in _token
+    void Binary(const cSerialWatcherRecord &Record, const Handler &handler);
+    void ArrayEnd(const Handler &handler); //emit the array collected from the binary array records
+    void Emit(cSerialWatcherEvent &Event, const Handler &handler);
+    static bool ParseNumber(const std::string &text, uint16_t max, uint16_t &val); //decimal digits only, true = valid and in range
+    static void Split(const std::string &text, char separator, std::vector<std::string> &fields);
+
+  // private attributes
+  private:
+    cSerialWatcherDecoder _decoder;
+    std::vector<cSerialWatcherElement> _table;
+    uint32_t _streams;
+    uint32_t _updates;
+    uint32_t _errors;
+    //ascii frame
+    char _frame; //SERIALWATCHER_ASCII_STREAM ... SERIALWATCHER_ASCII_VALUES_DELTA, '\0' = out of frame, SERIALWATCHER_ASCII_START = after '<'
+    bool _header; //version still to be received
+    uint8_t _flags; //stream end flags of the frame in progress
+    std::string _token; //chars received since the last element separator
+    std::vector<std::string> _fields;
+    std::vector<cSerialWatcherElement> _schema; //ascii schema frame, indexed by slot
+    int _schemaversion; //ascii schema version, -1 = no valid schema
+    //binary array in progress
+    bool _array;
+    cSerialWatcherEvent _arrayevent;
+};
+
+//rx commands <DataType"ArrayPlace"Value>, see src/cSerialWatcher.h (SERIALWATCHER_RX_CODE_STREAM_*)
+class cSerialWatcherCommand {
+
+  // public methods
+  public:
+    static std::string Write(uint16_t slot, uint8_t datatype, const std::string &value); //write a variable (value = index:value,value ... for a numeric array), empty = readonly datatype
+    static std::string Batch(const std::vector<std::string> &writes); //writes of Write() applied together by the board (SERIALWATCHER_RX_BATCH)
+    static std::string TxMode(uint8_t mode); //SERIALWATCHER_TX_MODE_*, combinable
+    static std::string Schema(); //ask a schema frame
+    static std::string Page(uint16_t size, uint16_t page); //paged streams (size 0 = whole table)
+    static std::string Scope(uint8_t decimation, const std::vector<uint16_t> &slots); //scope mode (decimation 0 = stop)
+    static std::string Subscribe(uint8_t op, uint16_t first, uint16_t last); //SERIALWATCHER_SUBSCRIBE_* of the slots first ... last
+    static std::vector<std::string> Subscribe(const std::vector<bool> &slots); //whole subscription as bitmap commands, slots[n] = slot n displayed
+
+  // private methods
+  private:
+    static std::string Command(char code, uint32_t place, const std::string &value);
+};
+
+#endif
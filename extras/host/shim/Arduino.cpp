@@ -0,0 +1,9 @@
+/*
+	Arduino.cpp
+
+	minimal host (pc) replacement of the arduino core, see Arduino.h
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Arduino.h"
+
+unsigned long ShimMicros = 0;
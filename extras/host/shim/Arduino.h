@@ -0,0 +1,77 @@
+/*
+	Arduino.h
+
+	minimal host (pc) replacement of the arduino core, only what src/cSerialWatcher.cpp uses
+	flash memory is plain memory, the clock is driven by the tests (ShimClock) and Stream is an interface for MockStream
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// Flash memory
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define PSTR(s) (s)
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_ptr(p) (*(void *const *)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcpy_P strcpy
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Clock, moved only by ShimClock() (or by the benchmarks)
+extern unsigned long ShimMicros;
+inline unsigned long micros() { return ShimMicros; }
+inline unsigned long millis() { return ShimMicros / 1000; }
+inline void ShimClock(unsigned long us) { ShimMicros += us; } //advance the clock
+inline void delay(unsigned long ms) { ShimClock(ms * 1000); }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// Print and Stream
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size) { size_t n = 0; while (size--) { n += write(*buffer++); } return n; }
+    size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+    virtual int availableForWrite() { return 0; }
+    size_t print(const __FlashStringHelper *str) { return write((const char *)str); }
+    size_t print(const char *str) { return write(str); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char n) { return printNumber(n, false); }
+    size_t print(int n) { return printNumber(n < 0 ? -(unsigned long long)n : n, n < 0); }
+    size_t print(unsigned int n) { return printNumber(n, false); }
+    size_t print(long n) { return printNumber(n < 0 ? -(unsigned long long)n : n, n < 0); }
+    size_t print(unsigned long n) { return printNumber(n, false); }
+    size_t print(double n, int digits = 2) { char buf[48]; snprintf(buf, sizeof(buf), "%.*f", digits, n); return write(buf); }
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+  private:
+    size_t printNumber(unsigned long long n, bool negative) { char buf[24]; snprintf(buf, sizeof(buf), negative ? "-%llu" : "%llu", n); return write(buf); }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+#endif
@@ -0,0 +1,28 @@
+/*
+	Check.h
+
+	tiny check macros of the host tests, each test is a function and main() returns the number of failed checks
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef Check_h
+#define Check_h
+
+#include <stdio.h>
+#include <string>
+
+extern int CheckFailures;
+
+#define CHECK(cond) do { if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); CheckFailures++; } } while (0)
+#define CHECK_EQ(a, b) do { if (!((a) == (b))) { printf("%s:%d: CHECK_EQ(%s, %s) failed: %s != %s\n", __FILE__, __LINE__, #a, #b, \
+  CheckText(a).c_str(), CheckText(b).c_str()); CheckFailures++; } } while (0)
+
+inline std::string CheckText(const std::string &s) { return "\"" + s + "\""; }
+inline std::string CheckText(const char *s) { return CheckText(std::string(s)); }
+template <typename T> std::string CheckText(T v) { return std::to_string(v); }
+
+#define CHECK_MAIN(...) int CheckFailures = 0; \
+  int main() { void (*tests[])() = { __VA_ARGS__ }; for (auto test : tests) { test(); } \
+    printf("%s\n", CheckFailures == 0 ? "ok" : "FAILED"); return CheckFailures == 0 ? 0 : 1; }
+
+#endif
@@ -0,0 +1,97 @@
+/*
+	Fixture.h
+
+	board side of the host tests: the library on a MockStream, the loops that drive it and the helpers that read what it sent
+	each test file keeps its own variables and map, the fixture is the rest
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef Fixture_h
+#define Fixture_h
+
+#include "cSerialWatcher.h"
+#include "cSerialWatcherDecoder.h"
+#include "cSerialWatcherStream.h"
+#include "MockStream.h"
+#include "Check.h"
+#include <vector>
+
+class Fixture {
+
+  // public methods
+  public:
+    Fixture() : W(S) {}
+    void Loop(int loops, unsigned long us = 1000) { //Update() and the clock, Each() before each Update()
+      for (int k = 0; k < loops; k++) {
+        if (Each != nullptr) {
+          Each();
+        }
+        W.Update();
+        ShimClock(us);
+      }
+    }
+    std::string Run(int loops, unsigned long us = 1000) { Loop(loops, us); return S.Take(); } //bytes sent in the loops
+    byte Command(const std::string &command) { S.Send(command); Loop(1); return W.RxError(); } //one rx command, RxError()
+
+  // public attributes
+  public:
+    MockStream S;
+    cSerialWatcher W;
+    void (*Each)() = nullptr; //moves the variables at each loop
+};
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+inline size_t Count(const std::string &tx, const std::string &what) {
+  size_t n = 0;
+  for (size_t k = tx.find(what); k != std::string::npos; k = tx.find(what, k + 1)) {
+    n++;
+  }
+  return n;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//first and last whole ascii stream <* ... *> in the bytes, "" when there is none
+inline std::string FirstStream(const std::string &tx, const std::string &start = "<*") {
+  size_t begin = tx.find(start);
+  size_t end = (begin == std::string::npos) ? begin : tx.find("*>", begin);
+  return (end == std::string::npos) ? "" : tx.substr(begin, end + 2 - begin);
+}
+inline std::string LastStream(const std::string &tx, const std::string &start = "<*") {
+  size_t end = tx.rfind("*>");
+  size_t begin = (end == std::string::npos) ? end : tx.rfind(start, end);
+  return (begin == std::string::npos) ? "" : tx.substr(begin, end + 2 - begin);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//elements of the first whole binary stream in the bytes
+inline std::vector<cSerialWatcherElement> Elements(const std::string &tx, cSerialWatcherDecoder &D) {
+  std::vector<cSerialWatcherElement> elements;
+  bool started = false, ended = false;
+  D.Feed((const uint8_t *)tx.data(), tx.size(), [&](const cSerialWatcherRecord &Record) {
+    cSerialWatcherElement Element;
+    if (Record.type == SERIALWATCHER_TX_BIN_RECORD_STREAM_START) {
+      started = true;
+    }
+    else if (Record.type == SERIALWATCHER_TX_BIN_RECORD_STREAM_END) {
+      ended = ended || started;
+    }
+    else if (started && !ended && cSerialWatcherDecoder::ParseElement(Record, Element)) {
+      elements.push_back(Element);
+    }
+  });
+  return elements;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the pc side: decodes the bytes into the table of the last values, any tx mode
+inline void Feed(cSerialWatcherStream &Pc, const std::string &tx) {
+  Pc.Feed((const uint8_t *)tx.data(), tx.size(), [](const cSerialWatcherEvent &) {});
+}
+inline std::string Value(const cSerialWatcherStream &Pc, uint16_t slot) {
+  if (slot >= Pc.Table().size() || Pc.Table()[slot].slot != slot) {
+    return "(not received)";
+  }
+  return cSerialWatcherDecoder::ValueToString(Pc.Table()[slot]);
+}
+
+#endif
@@ -0,0 +1,44 @@
+/*
+	MockStream.h
+
+	capturing Stream for the host tests and benchmarks
+	everything written goes to Tx, Rx holds the bytes to be read by the library, Room is what availableForWrite() returns, UsPerByte the time that each written byte takes
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef MockStream_h
+#define MockStream_h
+
+#include "Arduino.h"
+#include <string>
+
+class MockStream : public Stream {
+
+  // public methods
+  public:
+    size_t write(uint8_t c) override { Tx.push_back((char)c); ShimClock(UsPerByte); return 1; }
+    size_t write(const uint8_t *buffer, size_t size) override {
+      Tx.append((const char *)buffer, size);
+      ShimClock(size * UsPerByte);
+      if (Room > (int)size) { Room -= (int)size; } else if (Room >= 0) { Room = 0; }
+      Writes++;
+      return size;
+    }
+    int availableForWrite() override { return Room < 0 ? 63 : Room; } //63 = free room of an empty uno hardware serial buffer
+    int available() override { return (int)(Rx.size() - RxPos); }
+    int read() override { return RxPos < Rx.size() ? (uint8_t)Rx[RxPos++] : -1; }
+    int peek() override { return RxPos < Rx.size() ? (uint8_t)Rx[RxPos] : -1; }
+    void Send(const std::string &data) { Rx.append(data); } //bytes from the pc
+    std::string Take() { std::string out; out.swap(Tx); return out; } //bytes to the pc written so far
+
+  // public attributes
+  public:
+    std::string Tx; //written by the library
+    std::string Rx; //to be read by the library
+    size_t RxPos = 0;
+    int Room = -1; //availableForWrite(), -1 = always 63
+    unsigned long Writes = 0; //calls of write(buffer, size)
+    unsigned long UsPerByte = 0; //time spent by the writes, 0 = the clock moves only with ShimClock()
+};
+
+#endif
@@ -0,0 +1,118 @@
+/*
+	cSerialWatcherAlarmTest.cpp
+
+	host tests of the alarms: the sweep goes on between them, the stream period is kept, the whole 32 bit mask, the alarms between the streams
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+
+static uint32_t counter = 0; //changes at every loop
+static uint32_t bits = 0;
+static int16_t low = 0;
+static int16_t p0 = 10;
+static int16_t p1 = 11;
+static int16_t p2 = 12;
+static int16_t p3 = 13;
+static int16_t p4 = 14;
+static int16_t p5 = 15;
+
+static Fixture T;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void Change() {
+  counter++;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void MapAll() {
+  T.W.Map(F("counter"), counter);
+  T.W.Alarm(SERIALWATCHER_ALARM_CHANGE);
+  T.W.Map(F("bits"), bits);
+  T.W.Alarm(SERIALWATCHER_ALARM_MASK, 0x80000001UL); //bit 0 is lost through a float
+  T.W.Map(F("low"), low);
+  T.W.Alarm(SERIALWATCHER_ALARM_BELOW, -5); //an int limit keeps its sign
+  T.W.Map(F("p0"), p0);
+  T.W.Map(F("p1"), p1);
+  T.W.Map(F("p2"), p2);
+  T.W.Map(F("p3"), p3);
+  T.W.Map(F("p4"), p4);
+  T.W.Map(F("p5"), p5);
+  T.W.Update(); //the first Update() closes the map
+  T.Each = Change;
+  T.Loop(20);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//a variable that changes at every loop does not starve the sweep: the streams end and the change alarms are one for each stream
+static void TestSweep() {
+  MapAll();
+  std::string tx = T.Run(300);
+  size_t streams = Count(tx, "*>");
+  CHECK(streams >= 5);
+  CHECK(Count(tx, "^0\"1\"") <= streams + 1);
+  CHECK(LastStream(tx).find("8\"p5\"15\"") != std::string::npos);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the pending alarms do not start the next stream before SERIALWATCHER_TX_STREAM_PERIOD
+static void TestPeriod() {
+  std::string tx = T.Run(300, 0);
+  CHECK(Count(tx, "<*") <= 1);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the mask keeps all its 32 bits, the int limit its sign
+static void TestMask() {
+  T.Run(60);
+  bits = 1;
+  low = -10;
+  std::string tx = T.Run(60);
+  CHECK(tx.find("^1\"1\"1\"") != std::string::npos);
+  CHECK(tx.find("^2\"1\"-10\"") != std::string::npos);
+  bits = 0x10;
+  tx = T.Run(60);
+  CHECK(tx.find("^1\"0\"16\"") != std::string::npos);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//an alarm raised between the streams is sent at the next Update(), the next stream still waits for its period
+static void TestWait() {
+  T.Each = nullptr;
+  low = 0;
+  T.Run(60);
+  bool wait = false;
+  for (int k = 0; k < 60 && !wait; k++) {
+    wait = T.Run(1).find("*>") != std::string::npos; //stream end
+  }
+  CHECK(wait);
+  low = -20;
+  std::string tx = T.Run(1);
+  CHECK(tx.find("^2\"1\"-20\"") != std::string::npos);
+  CHECK(tx.find("<*") == std::string::npos);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the integer limits of any width: exact mask, signed limit
+static void TestIntegers() {
+  Fixture T;
+  static uint8_t u8 = 0;
+  static int32_t i32 = 0;
+  static uint16_t u16 = 0;
+  T.W.Map(F("u8"), u8);
+  T.W.Alarm(SERIALWATCHER_ALARM_MASK, (uint8_t)0x81);
+  T.W.Map(F("i32"), i32);
+  T.W.Alarm(SERIALWATCHER_ALARM_BELOW, -100000L);
+  T.W.Map(F("u16"), u16);
+  T.W.Alarm(SERIALWATCHER_ALARM_ABOVE, 2.5); //double
+  T.Run(60);
+  u8 = 1;
+  i32 = -100001;
+  u16 = 3;
+  std::string tx = T.Run(60);
+  CHECK(tx.find("^0\"1\"1\"") != std::string::npos);
+  CHECK(tx.find("^1\"1\"-100001\"") != std::string::npos);
+  CHECK(tx.find("^2\"1\"3\"") != std::string::npos);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestSweep, TestPeriod, TestMask, TestWait, TestIntegers)
@@ -0,0 +1,63 @@
+/*
+	cSerialWatcherBatchTest.cpp
+
+	host tests of the batched writes: applied together at the next Update(), all or nothing, one acknowledge for each batch
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+
+static float kp = 1;
+static float ki = 0;
+static float kd = 0;
+static int16_t mode = 0;
+static char txt[8] = "";
+
+static Fixture T;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//sends one batch, returns the acknowledge of the next stream
+static std::string Batch(const std::string &batch) {
+  static bool mapped = false;
+  if (!mapped) {
+    T.W.Map(F("kp"), kp);     //0
+    T.W.Map(F("ki"), ki);     //1
+    T.W.Map(F("kd"), kd);     //2
+    T.W.Map(F("mode"), mode); //3
+    T.W.Map(F("txt"), txt);   //4
+    T.W.Update(); //the first Update() closes the map
+    mapped = true;
+  }
+  T.S.Send(batch);
+  std::string stream = FirstStream(T.Run(80));
+  size_t ack = stream.find('!');
+  return (ack == std::string::npos) ? "" : stream.substr(ack, stream.find(';', ack) + 1 - ack);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the staged writes are applied together at the start of the next Update()
+static void TestApply() {
+  Batch("");
+  T.S.Send("<f\"0\"1.5|f\"1\"0.25|f\"2\"0.125|i\"3\"7>");
+  T.Loop(1);
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_OK);
+  CHECK(kp == 1 && ki == 0 && kd == 0 && mode == 0); //received, not yet applied
+  T.Loop(1);
+  CHECK(kp == 1.5f && ki == 0.25f && kd == 0.125f && mode == 7);
+  std::string stream = FirstStream(T.Run(80));
+  CHECK(stream.find("!1\"0\"4;") != std::string::npos);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//with an error in any write no variable is modified
+static void TestReject() {
+  CHECK_EQ(Batch("<f\"0\"9|i\"3\"99999>"), std::string("!2\"6\"0;")); //out of the int16_t range
+  CHECK_EQ(Batch("<f\"0\"9|f\"9\"1>"), std::string("!3\"3\"0;"));     //not mapped
+  CHECK_EQ(Batch("<f\"0\"9|s\"4\"ab>"), std::string("!4\"4\"0;"));    //the texts are written one at a time
+  CHECK_EQ(Batch("<f\"0\"9|f\"1\"9|f\"2\"9|i\"3\"9|f\"0\"8>"), std::string("!5\"9\"0;")); //more than SERIALWATCHER_RX_BATCH_MAX writes
+  CHECK(kp == 1.5f && ki == 0.25f && kd == 0.125f && mode == 7);
+  CHECK_EQ(Batch("<f\"0\"2|f\"1\"0.5>"), std::string("!6\"0\"2;"));
+  CHECK(kp == 2 && ki == 0.5f);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestApply, TestReject)
@@ -0,0 +1,81 @@
+/*
+	cSerialWatcherBinaryTest.cpp
+
+	host round-trip tests of the binary records: board (cSerialWatcher) -> pc (cSerialWatcherDecoder)
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+
+static bool b = true;
+static int8_t i8 = -100;
+static uint16_t u16 = 65535;
+static int32_t i32 = -2147483647 - 1;
+static uint64_t u64 = 18446744073709551615ull;
+static int64_t i64 = -42;
+static float f = -1.25f;
+static char c = 'x';
+static char txt[16] = "hello";
+static uint8_t ro = 7;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void MapAll(cSerialWatcher &W) {
+  W.Map(F("b"), b);
+  W.Map(F("i8"), i8);
+  W.Map(F("u16"), u16);
+  W.Map(F("i32"), i32);
+  W.Map(F("u64"), u64);
+  W.Map(F("i64"), i64);
+  W.Map(F("f"), f);
+  W.Map(F("c"), c);
+  W.Map(F("txt"), txt);
+  W.Map(F("ro"), ro, true);
+  W.Text(F("hi"));
+  W.Update(); //the first Update() closes the map
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestRoundTrip() {
+  Fixture T;
+  T.W.TxMode(SERIALWATCHER_TX_MODE_BINARY);
+  MapAll(T.W);
+  cSerialWatcherDecoder D;
+  std::vector<cSerialWatcherElement> elements = Elements(T.Run(20), D);
+  CHECK_EQ(D.Errors(), 0u);
+  const char *names[] = { "b", "i8", "u16", "i32", "u64", "i64", "f", "c", "txt", "ro", "hi" };
+  const char *values[] = { "1", "-100", "65535", "-2147483648", "18446744073709551615", "-42", "-1.25", "x", "hello", "7", "" };
+  const uint8_t types[] = { SERIALWATCHER_DATATYPE_bool, SERIALWATCHER_DATATYPE_int8_t, SERIALWATCHER_DATATYPE_uint16_t, SERIALWATCHER_DATATYPE_int32_t,
+    SERIALWATCHER_DATATYPE_uint64_t, SERIALWATCHER_DATATYPE_int64_t, SERIALWATCHER_DATATYPE_float, SERIALWATCHER_DATATYPE_char,
+    SERIALWATCHER_DATATYPE_achar, SERIALWATCHER_DATATYPE_uint8_t, SERIALWATCHER_DATATYPE_flashstring };
+  CHECK_EQ(elements.size(), (size_t)11);
+  for (size_t k = 0; k < elements.size() && k < 11; k++) {
+    CHECK_EQ(elements[k].slot, k);
+    CHECK_EQ(elements[k].name, std::string(names[k]));
+    CHECK_EQ(cSerialWatcherDecoder::ValueToString(elements[k]).substr(0, strlen(values[k])), std::string(values[k]));
+    CHECK_EQ(elements[k].features & SERIALWATCHER_FEATURES_MASK_DATATYPE, types[k]);
+  }
+  if (elements.size() > 9) {
+    CHECK((elements[9].features & SERIALWATCHER_FEATURES_MASK_READONLY) != 0);
+    CHECK((elements[8].features & SERIALWATCHER_FEATURES_MASK_READONLY) == 0);
+  }
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the pc selects the mode, the board switches at the next stream start and the values written by the pc come back
+static void TestModeSwitch() {
+  Fixture T;
+  MapAll(T.W);
+  T.Loop(5);
+  T.S.Send("<p\"0\"1>");
+  std::string tx = T.Run(40);
+  CHECK_EQ(tx.find("<*"), (size_t)0);
+  cSerialWatcherDecoder D;
+  CHECK_EQ(Elements(tx.substr(tx.find("*>") + 2), D).size(), (size_t)11);
+  T.S.Send("<l\"3\"123456789>");
+  std::vector<cSerialWatcherElement> elements = Elements(T.Run(40), D);
+  CHECK(elements.size() > 3 && cSerialWatcherDecoder::ValueToString(elements[3]) == "123456789");
+  CHECK_EQ(D.Errors(), 0u);
+  i32 = -2147483647 - 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestRoundTrip, TestModeSwitch)
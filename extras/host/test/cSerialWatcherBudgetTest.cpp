@@ -0,0 +1,73 @@
+/*
+	cSerialWatcherBudgetTest.cpp
+
+	host tests of the tx budget of each Update(): one element without a budget, the cutoff in bytes and in microseconds
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+
+static int16_t v[10] = { 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 };
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void MapAll(cSerialWatcher &W) {
+  W.Map(F("v0"), v[0]); //each element is 10 bytes: 0"v0"10"3;
+  W.Map(F("v1"), v[1]);
+  W.Map(F("v2"), v[2]);
+  W.Map(F("v3"), v[3]);
+  W.Map(F("v4"), v[4]);
+  W.Map(F("v5"), v[5]);
+  W.Map(F("v6"), v[6]);
+  W.Map(F("v7"), v[7]);
+  W.Map(F("v8"), v[8]);
+  W.Map(F("v9"), v[9]);
+  W.Update(); //the first Update() closes the map
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//most elements sent by one Update() over the next loops
+static size_t MostElements(Fixture &T, int loops) {
+  size_t most = 0;
+  for (int k = 0; k < loops; k++) {
+    size_t elements = Count(T.Run(1), ";");
+    most = (elements > most) ? elements : most;
+  }
+  return most;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestNoBudget() {
+  Fixture T;
+  MapAll(T.W);
+  CHECK_EQ(MostElements(T, 100), (size_t)1);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the elements go on until the bytes sent reach the budget: the last one can cross it
+static void TestBytes() {
+  Fixture T;
+  MapAll(T.W);
+  T.W.TxBudget(0, 35);
+  CHECK_EQ(MostElements(T, 100), (size_t)4);
+  T.W.TxBudget(0, 1000);
+  bool whole = false; //a whole stream in one Update()
+  for (int k = 0; k < 60 && !whole; k++) {
+    std::string tx = T.Run(1);
+    whole = tx.find("<*") != std::string::npos && tx.find("*>") != std::string::npos;
+  }
+  CHECK(whole);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the elements go on until the time of the writes reaches the budget
+static void TestMicros() {
+  Fixture T;
+  T.S.UsPerByte = 87; //115200 baud
+  MapAll(T.W);
+  T.W.TxBudget(250);
+  CHECK_EQ(MostElements(T, 200), (size_t)1); //each element takes 870 us
+  T.W.TxBudget(2000);
+  CHECK_EQ(MostElements(T, 200), (size_t)3);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestNoBudget, TestBytes, TestMicros)
@@ -0,0 +1,112 @@
+/*
+	cSerialWatcherCompactTest.cpp
+
+	host round-trip tests of the compact binary values (varint, zigzag and packed numeric arrays): board (cSerialWatcher) -> pc (cSerialWatcherStream)
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+
+static int8_t i8 = -128;
+static uint8_t u8 = 255;
+static int16_t i16 = -1;
+static uint16_t u16 = 128;
+static int32_t i32 = -2147483647 - 1;
+static uint32_t u32 = 4294967295u;
+static int64_t i64 = INT64_MIN;
+static uint64_t u64 = UINT64_MAX;
+static float f = 1.5f;
+static int16_t runs[40]; //runs of equal values and literals
+static uint32_t flat[20]; //one long run
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void MapAll(cSerialWatcher &W) {
+  for (int k = 0; k < 40; k++) {
+    runs[k] = (k < 17) ? 0 : (k < 25) ? (int16_t)(k * 1000) : -5;
+  }
+  W.Map(F("i8"), i8);
+  W.Map(F("u8"), u8);
+  W.Map(F("i16"), i16);
+  W.Map(F("u16"), u16);
+  W.Map(F("i32"), i32);
+  W.Map(F("u32"), u32);
+  W.Map(F("i64"), i64);
+  W.Map(F("u64"), u64);
+  W.Map(F("f"), f);
+  W.Map(F("runs"), runs);
+  W.Map(F("flat"), flat);
+  W.Update(); //the first Update() closes the map
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//texts of the slots of the last whole stream, and size of the stream
+static std::vector<std::string> Frame(Fixture &T, cSerialWatcherStream &Pc, size_t &bytes) {
+  uint32_t streams = Pc.Streams();
+  std::string tx = T.Run(200);
+  Feed(Pc, tx);
+  CHECK_EQ(Pc.Errors(), 0u);
+  CHECK(Pc.Streams() >= streams + 2);
+  bytes = tx.size() / (Pc.Streams() - streams + (Pc.Streams() == streams));
+  std::vector<std::string> texts;
+  for (const cSerialWatcherElement &Element : Pc.Table()) {
+    texts.push_back(cSerialWatcherDecoder::ValueToString(Element));
+  }
+  return texts;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the same values with and without the compact encoding, the compact frame is smaller
+static void TestRoundTrip() {
+  Fixture T;
+  T.W.TxMode(SERIALWATCHER_TX_MODE_BINARY);
+  cSerialWatcherStream Pc;
+  MapAll(T.W);
+  size_t plainbytes, compactbytes;
+  std::vector<std::string> plain = Frame(T, Pc, plainbytes);
+  T.W.TxMode(SERIALWATCHER_TX_MODE_BINARY | SERIALWATCHER_TX_MODE_COMPACT);
+  Frame(T, Pc, compactbytes); //mode switch
+  std::vector<std::string> compact = Frame(T, Pc, compactbytes);
+  CHECK_EQ(plain.size(), (size_t)11);
+  CHECK(plain == compact);
+  CHECK(compactbytes < plainbytes);
+  const char *values[] = { "-128", "255", "-1", "128", "-2147483648", "4294967295", "-9223372036854775808", "18446744073709551615" };
+  for (size_t k = 0; k < 8 && k < compact.size(); k++) {
+    CHECK_EQ(compact[k], std::string(values[k]));
+  }
+  std::string expected;
+  for (int k = 0; k < 40; k++) {
+    expected += (k ? "," : "") + std::to_string(runs[k]);
+  }
+  if (compact.size() == 11) {
+    CHECK_EQ(compact[9], expected);
+    CHECK_EQ(compact[10], std::string("0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0"));
+  }
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//every value of each integer datatype around the varint byte boundaries
+static void TestVarintBoundaries() {
+  Fixture T;
+  T.W.TxMode(SERIALWATCHER_TX_MODE_BINARY | SERIALWATCHER_TX_MODE_COMPACT);
+  cSerialWatcherStream Pc;
+  MapAll(T.W);
+  size_t bytes;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint64_t edge = (uint64_t)1 << shift;
+    for (int d = -1; d <= 1; d++) {
+      u64 = edge + d;
+      i64 = -(int64_t)(edge + d);
+      u32 = (uint32_t)(edge + d);
+      i32 = (int32_t)(edge + d);
+      i16 = (int16_t)-(int64_t)(edge + d);
+      std::vector<std::string> texts = Frame(T, Pc, bytes);
+      CHECK(texts.size() > 7 && texts[7] == std::to_string(u64));
+      CHECK(texts.size() > 6 && texts[6] == std::to_string(i64));
+      CHECK(texts.size() > 5 && texts[5] == std::to_string(u32));
+      CHECK(texts.size() > 4 && texts[4] == std::to_string(i32));
+      CHECK(texts.size() > 2 && texts[2] == std::to_string(i16));
+    }
+  }
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestRoundTrip, TestVarintBoundaries)
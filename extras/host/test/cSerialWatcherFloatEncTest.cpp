@@ -0,0 +1,98 @@
+/*
+	cSerialWatcherFloatEncTest.cpp
+
+	host round-trip tests of the float encodings: half precision and fixed point, board (cSerialWatcher) -> pc (cSerialWatcherDecoder)
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+#include <math.h>
+
+static float raw = 0;
+static float half = 0;
+static float fixed = 20;
+
+static Fixture T;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//elements of the first whole binary stream after the values have been set
+static std::vector<cSerialWatcherElement> Stream() {
+  static bool mapped = false;
+  if (!mapped) {
+    T.W.TxMode(SERIALWATCHER_TX_MODE_BINARY);
+    T.W.Map(F("raw"), raw);
+    T.W.Map(F("half"), half);
+    T.W.FloatEncoding(SERIALWATCHER_FLOAT_HALF);
+    T.W.Map(F("fixed"), fixed);
+    T.W.FloatEncoding(SERIALWATCHER_FLOAT_FIXED, 0.01, 20); //value = 20 + integer * 0.01
+    T.W.Update(); //the first Update() closes the map
+    mapped = true;
+  }
+  cSerialWatcherDecoder D;
+  std::vector<cSerialWatcherElement> elements = Elements(T.Run(60), D);
+  CHECK_EQ(D.Errors(), 0u);
+  CHECK_EQ(elements.size(), (size_t)3);
+  return elements;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//decoded float of an element, printed with 2 decimals as in the ascii mode
+static float Decoded(const cSerialWatcherElement &Element) {
+  return std::stof(cSerialWatcherDecoder::ValueToString(Element));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestDatatypes() {
+  std::vector<cSerialWatcherElement> elements = Stream();
+  if (elements.size() == 3) {
+    CHECK_EQ(elements[0].features & SERIALWATCHER_FEATURES_MASK_DATATYPE, SERIALWATCHER_DATATYPE_float);
+    CHECK_EQ(elements[1].features & SERIALWATCHER_FEATURES_MASK_DATATYPE, SERIALWATCHER_DATATYPE_half);
+    CHECK_EQ(elements[1].value.size(), (size_t)2);
+    CHECK_EQ(elements[2].features & SERIALWATCHER_FEATURES_MASK_DATATYPE, SERIALWATCHER_DATATYPE_fixed16);
+    CHECK_EQ(elements[2].value.size(), (size_t)2);
+    CHECK(elements[2].scale == 0.01f && elements[2].offset == 20);
+  }
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//half precision: 11 significant bits, up to 65504 (plus the 2 decimals of the print)
+static void TestHalf() {
+  const float values[] = { 0, 1.5f, -2.25f, 0.1f, 1000.5f, 65504, -65504, 6.1e-5f };
+  for (float value : values) {
+    half = value;
+    std::vector<cSerialWatcherElement> elements = Stream();
+    if (elements.size() == 3) {
+      CHECK(fabsf(Decoded(elements[1]) - value) <= fabsf(value) / 1024 + 0.005f);
+    }
+  }
+  half = 1e6f; //beyond the half range
+  std::vector<cSerialWatcherElement> elements = Stream();
+  if (elements.size() == 3) {
+    CHECK_EQ(cSerialWatcherDecoder::ValueToString(elements[1]), std::string("inf"));
+  }
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//fixed point: one step of the scale, clamped to the int16_t range
+static void TestFixed() {
+  const float values[] = { 20, 21.37f, -5.5f, 347.67f, -307.68f };
+  for (float value : values) {
+    fixed = value;
+    std::vector<cSerialWatcherElement> elements = Stream();
+    if (elements.size() == 3) {
+      CHECK(fabsf(Decoded(elements[2]) - value) <= 0.005f + 1e-4f);
+    }
+  }
+  fixed = 1000; //beyond 20 + 32767 * 0.01
+  std::vector<cSerialWatcherElement> elements = Stream();
+  if (elements.size() == 3) {
+    CHECK(fabsf(Decoded(elements[2]) - 347.67f) < 1e-3f);
+  }
+  raw = 1000; //the raw float is unchanged
+  elements = Stream();
+  if (elements.size() == 3) {
+    CHECK_EQ(Decoded(elements[0]), 1000.0f);
+  }
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestDatatypes, TestHalf, TestFixed)
@@ -0,0 +1,96 @@
+/*
+	cSerialWatcherFormatTest.cpp
+
+	host tests of the value formatting of the ascii stream (datatype traits, see cSerialWatcher.h), checked against printf
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "cSerialWatcher.h"
+#include "Check.h"
+#include <inttypes.h>
+#include <stdarg.h>
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+template <typename T> static std::string Format(T value) {
+  char dst[32];
+  byte n = cSerialWatcherTraits<T>::codec.Format(dst, &value);
+  return std::string(dst, n);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static uint64_t Random() { //xorshift64, fixed seed
+  static uint64_t x = 88172645463325252ull;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return x;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static std::string Printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+static std::string Printf(const char *format, ...) {
+  char buf[48];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  return buf;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestEdges() {
+  CHECK_EQ(Format<uint8_t>(0), std::string("0"));
+  CHECK_EQ(Format<uint8_t>(255), std::string("255"));
+  CHECK_EQ(Format<int8_t>(-128), std::string("-128"));
+  CHECK_EQ(Format<int16_t>(-32768), std::string("-32768"));
+  CHECK_EQ(Format<uint16_t>(65535), std::string("65535"));
+  CHECK_EQ(Format<int32_t>(INT32_MIN), std::string("-2147483648"));
+  CHECK_EQ(Format<uint32_t>(UINT32_MAX), std::string("4294967295"));
+  CHECK_EQ(Format<int64_t>(INT64_MIN), std::string("-9223372036854775808"));
+  CHECK_EQ(Format<int64_t>(INT64_MAX), std::string("9223372036854775807"));
+  CHECK_EQ(Format<uint64_t>(UINT64_MAX), std::string("18446744073709551615"));
+  CHECK_EQ(Format<bool>(true), std::string("1"));
+  CHECK_EQ(Format<char>('x'), std::string("x"));
+  //each power of ten and its neighbours (digit count changes)
+  uint64_t p = 1;
+  for (int k = 0; k < 20; k++) {
+    CHECK_EQ(Format<uint64_t>(p), Printf("%" PRIu64, p));
+    CHECK_EQ(Format<uint64_t>(p - 1), Printf("%" PRIu64, p - 1));
+    CHECK_EQ(Format<uint64_t>(p + 1), Printf("%" PRIu64, p + 1));
+    CHECK_EQ(Format<int64_t>(-(int64_t)p), Printf("%" PRId64, -(int64_t)p));
+    if (p <= UINT32_MAX) {
+      CHECK_EQ(Format<uint32_t>((uint32_t)p), Printf("%" PRIu32, (uint32_t)p));
+      CHECK_EQ(Format<uint32_t>((uint32_t)p - 1), Printf("%" PRIu32, (uint32_t)p - 1));
+      CHECK_EQ(Format<int32_t>(-(int32_t)(p - 1)), Printf("%" PRId32, -(int32_t)(p - 1)));
+    }
+    p *= 10;
+  }
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestRandom() {
+  for (int k = 0; k < 100000 && CheckFailures < 10; k++) {
+    uint64_t r = Random() >> (Random() % 64); //all the digit counts
+    CHECK_EQ(Format<uint64_t>(r), Printf("%" PRIu64, r));
+    CHECK_EQ(Format<int64_t>((int64_t)r), Printf("%" PRId64, (int64_t)r));
+    CHECK_EQ(Format<uint32_t>((uint32_t)r), Printf("%" PRIu32, (uint32_t)r));
+    CHECK_EQ(Format<int32_t>((int32_t)r), Printf("%" PRId32, (int32_t)r));
+    CHECK_EQ(Format<uint16_t>((uint16_t)r), Printf("%u", (unsigned)(uint16_t)r));
+    CHECK_EQ(Format<int16_t>((int16_t)r), Printf("%d", (int)(int16_t)r));
+  }
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//same text of Print::print(float) of the arduino core: two decimals, nan, inf, ovf
+static void TestFloat() {
+  CHECK_EQ(Format<float>(3.5f), std::string("3.50"));
+  CHECK_EQ(Format<float>(-1.25f), std::string("-1.25"));
+  CHECK_EQ(Format<float>(0.004f), std::string("0.00"));
+  CHECK_EQ(Format<float>(0.006f), std::string("0.01"));
+  CHECK_EQ(Format<float>(4294967040.0f), std::string("4294967040.00"));
+  CHECK_EQ(Format<float>(1e10f), std::string("ovf"));
+  CHECK_EQ(Format<float>(-INFINITY), std::string("inf"));
+  CHECK_EQ(Format<float>(NAN), std::string("nan"));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestEdges, TestRandom, TestFloat)
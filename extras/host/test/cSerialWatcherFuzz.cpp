@@ -0,0 +1,97 @@
+/*
+	cSerialWatcherFuzz.cpp
+
+	fuzz harness of the rx command parser: any byte sequence must be rejected or applied, without touching memory out of the mapped variables
+	  - clang: libFuzzer target (cSerialWatcherLibFuzzer, build with -DSERIALWATCHER_LIBFUZZER)
+	  - any compiler: standalone driver that mutates valid commands with a fixed seed (cSerialWatcherFuzz, run by ctest with the sanitizers)
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "cSerialWatcher.h"
+#include "MockStream.h"
+#include "Check.h"
+
+static int16_t i16 = 0;
+static uint64_t u64 = 0;
+static float f = 0;
+static bool b = false;
+static char txt[SERIALWATCHER_RX_ARRAY_LENGTH] = ""; //any text written by the pc fits
+static int32_t adc[8] = { 0 };
+static uint8_t ro = 42; //readonly, must never change
+static uint8_t rodata[4] = { 1, 2, 3, 4 }; //readonly array, must never change
+
+static MockStream S;
+static cSerialWatcher W(S);
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  static bool mapped = false;
+  if (!mapped) {
+    W.Map(F("i16"), i16);
+    W.Map(F("u64"), u64);
+    W.Map(F("f"), f);
+    W.Map(F("b"), b);
+    W.Map(F("txt"), txt);
+    W.Map(F("adc"), adc);
+    W.Map(F("ro"), ro, true);
+    W.Map(F("rodata"), rodata, true);
+    W.TxMode(SERIALWATCHER_TX_MODE_BINARY);
+    W.Update(); //the first Update() closes the map
+    mapped = true;
+  }
+  S.Rx.assign((const char *)data, size);
+  S.RxPos = 0;
+  for (int k = 0; k < 4 || S.available() > 0; k++) { //all the bytes, plus a few loops for the tx of what they selected
+    W.Update();
+    ShimClock(1000);
+  }
+  S.Take();
+  if (ro != 42 || rodata[0] != 1 || rodata[3] != 4 || strlen(txt) >= sizeof(txt)) {
+    abort();
+  }
+  return 0;
+}
+
+#ifndef SERIALWATCHER_LIBFUZZER
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static uint32_t Random() { //xorshift32, fixed seed so a failure can be replayed
+  static uint32_t x = 2463534242u;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+int CheckFailures = 0;
+int main(int argc, char **argv) {
+  static const char *const seeds[] = {
+    "<i\"0\"-12>", "<m\"1\"18446744073709551615>", "<f\"2\"-1.5e3>", "<b\"3\"1>", "<s\"4\"hello>", "<l\"5\"2:10,11,12>",
+    "<d\"6\"1>", "<d\"7\"0:9>", "<p\"0\"1>", "<p\"0\"0>", "<g\"4\"1>", "<h\"0\"0>", "<o\"1\"0,5>", "<o\"0\"0>",
+    "<k\"0\"0-3,5>", "<k\"1\"*>", "<K\"0\"FF>", "<i\"0\"1|f\"2\"2|l\"5\"0:1>",
+  };
+  const char alphabet[] = "<>\"|:,-*0123456789.eEabcdfghiklmnopqrsuxKF ";
+  unsigned long runs = (argc > 1) ? strtoul(argv[1], NULL, 10) : 200000;
+  for (unsigned long n = 0; n < runs; n++) {
+    std::string input;
+    int commands = 1 + Random() % 3;
+    for (int k = 0; k < commands; k++) {
+      std::string command = seeds[Random() % (sizeof(seeds) / sizeof(seeds[0]))];
+      int mutations = Random() % 4;
+      for (int m = 0; m < mutations; m++) {
+        size_t pos = Random() % (command.size() + 1);
+        switch (Random() % 4) {
+          case 0: command.insert(pos, 1, alphabet[Random() % (sizeof(alphabet) - 1)]); break;
+          case 1: if (pos < command.size()) { command.erase(pos, 1); } break;
+          case 2: if (pos < command.size()) { command[pos] = (char)Random(); } break;
+          default: command.insert(pos, std::string(Random() % 40, alphabet[Random() % (sizeof(alphabet) - 1)])); break;
+        }
+      }
+      input += command;
+    }
+    LLVMFuzzerTestOneInput((const uint8_t *)input.data(), input.size());
+  }
+  CHECK_EQ(ro, 42);
+  printf("%lu inputs %s\n", runs, CheckFailures == 0 ? "ok" : "FAILED");
+  return CheckFailures == 0 ? 0 : 1;
+}
+#endif
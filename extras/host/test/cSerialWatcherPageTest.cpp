@@ -0,0 +1,61 @@
+/*
+	cSerialWatcherPageTest.cpp
+
+	host tests of the paged streams on the dynamic slot arrays (allocated while the variables are mapped)
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+#include <stdlib.h>
+
+static int16_t v[10] = { 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 };
+
+static Fixture T;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//sends the commands and returns the first whole stream after them
+static std::string Stream(const std::string &commands) {
+  static bool mapped = false;
+  if (!mapped) {
+    void *dirty = malloc(1024); //the grown slot arrays must not inherit the old heap bytes
+    memset(dirty, 0xFF, 1024);
+    free(dirty);
+    T.W.Map(F("v0"), v[0]);
+    T.W.Map(F("v1"), v[1]);
+    T.W.Map(F("v2"), v[2]);
+    T.W.Map(F("v3"), v[3]);
+    T.W.Map(F("v4"), v[4]);
+    T.W.Map(F("v5"), v[5]);
+    T.W.Map(F("v6"), v[6]);
+    T.W.Map(F("v7"), v[7]);
+    T.W.Map(F("v8"), v[8]);
+    T.W.Map(F("v9"), v[9]);
+    T.W.Update(); //the first Update() closes the map
+    mapped = true;
+  }
+  T.S.Send(commands);
+  return FirstStream(T.Run(80));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the slots mapped over three blocks are all sent and subscribed
+static void TestWhole() {
+  std::string stream = Stream("");
+  CHECK_EQ(stream.substr(0, 12), std::string("<*0\"v0\"10\"3;"));
+  CHECK(stream.find("9\"v9\"19\"3;*>") != std::string::npos);
+  CHECK_EQ(Count(stream, ";"), (size_t)10);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestPage() {
+  CHECK_EQ(Stream("<g\"4\"1>"), std::string("<*@1\"3;4\"v4\"14\"3;5\"v5\"15\"3;6\"v6\"16\"3;7\"v7\"17\"3;*>"));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_OK);
+  CHECK_EQ(Stream("<g\"4\"2>"), std::string("<*@2\"3;8\"v8\"18\"3;9\"v9\"19\"3;*>")); //the last page is shorter
+  CHECK_EQ(Stream("<g\"4\"3>"), std::string("<*@2\"3;8\"v8\"18\"3;9\"v9\"19\"3;*>")); //no slots in the page: unchanged
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_ERROR_SLOT);
+  CHECK_EQ(Stream("<g\"4\"1><k\"2\"5>"), std::string("<*@1\"3;4\"v4\"14\"3;6\"v6\"16\"3;7\"v7\"17\"3;*>")); //the page of the subscribed slots
+  Stream("<k\"0\"*>");
+  CHECK_EQ(Count(Stream("<g\"0\"0>"), ";"), (size_t)10); //the whole table again
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestWhole, TestPage)
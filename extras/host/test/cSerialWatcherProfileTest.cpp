@@ -0,0 +1,48 @@
+/*
+	cSerialWatcherProfileTest.cpp
+
+	host tests of the profiling slots (SERIALWATCHER_PROFILE, built with SERIALWATCHER_TX_MAX_VALUES 12 and SERIALWATCHER_TX_NUMARRAYS_MAX 1)
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+
+static int16_t a = 1;
+static int16_t b = 2;
+static int16_t pair[2] = { 3, 4 };
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestAppended() {
+  Fixture T;
+  T.W.Map(F("a"), a);
+  std::string tx = T.Run(60);
+  CHECK(tx.find("0\"a\"1\"3;1\"sw.tx_us\"") != std::string::npos);
+  CHECK(tx.find("10\"sw.free\"") != std::string::npos);
+  CHECK(tx.find("*1*") == std::string::npos);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//no room for all the profiling slots: none is added and the table is reported exceeded
+static void TestNoRoom() {
+  Fixture T;
+  T.W.Map(F("a"), a);
+  T.W.Map(F("b"), b);
+  std::string tx = T.Run(60);
+  CHECK(tx.find("sw.") == std::string::npos);
+  CHECK(tx.find("1\"b\"2\"3;*1*") != std::string::npos);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the loop histogram has its own numeric array entry, the user arrays can take all the SERIALWATCHER_TX_NUMARRAYS_MAX ones
+static void TestArraysInUse() {
+  Fixture T;
+  T.W.Map(F("pair"), pair);
+  std::string stream = LastStream(T.Run(60));
+  CHECK(stream.find("0\"pair\"3,4\"") != std::string::npos);
+  size_t loop = stream.find("4\"sw.loop\"");
+  CHECK(loop != std::string::npos);
+  std::string histogram = stream.substr(loop + 11, stream.find('"', loop + 11) - loop - 11);
+  CHECK_EQ(Count(histogram, ","), (size_t)(SERIALWATCHER_PROFILE_BUCKETS - 1));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestAppended, TestNoRoom, TestArraysInUse)
@@ -0,0 +1,85 @@
+/*
+	cSerialWatcherRefreshTest.cpp
+
+	host tests of the refresh classes: every stream, every n streams (spread over the streams), on change only, the keyframes
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+#include <vector>
+
+static int16_t a = 1;
+static int16_t b = 2;
+static int16_t c = 3;
+
+static Fixture T;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//whole streams in the bytes: keyframes <* ... *> and delta streams <+ ... *>
+static std::vector<std::string> Streams(const std::string &tx) {
+  std::vector<std::string> streams;
+  for (size_t k = tx.find('<'); k != std::string::npos; k = tx.find('<', k + 1)) {
+    size_t end = tx.find("*>", k);
+    if ((tx.compare(k, 2, "<*") == 0 || tx.compare(k, 2, "<+") == 0) && end != std::string::npos) {
+      streams.push_back(tx.substr(k, end + 2 - k));
+    }
+  }
+  return streams;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void MapAll() {
+  T.W.Map(F("a"), a);
+  T.W.Map(F("b"), b);
+  T.W.Refresh(4);
+  T.W.Map(F("c"), c);
+  T.W.Refresh(SERIALWATCHER_REFRESH_ONCHANGE);
+  T.W.Update(); //the first Update() closes the map
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//b is sent once every 4 streams, a in all of them, all the slots in the keyframes (one every SERIALWATCHER_TX_DELTA_KEYFRAME streams)
+static void TestEvery() {
+  MapAll();
+  std::vector<std::string> streams = Streams(T.Run(1200));
+  int lastb = -1, lastkey = -1;
+  CHECK(streams.size() >= 2 * SERIALWATCHER_TX_DELTA_KEYFRAME);
+  for (int k = 0; k < (int)streams.size(); k++) {
+    CHECK(streams[k].find("0\"a\"1\"") != std::string::npos);
+    if (streams[k].compare(0, 2, "<*") == 0) {
+      CHECK(streams[k].find("1\"b\"2\"") != std::string::npos && streams[k].find("2\"c\"3\"") != std::string::npos);
+      CHECK(lastkey < 0 || k - lastkey == SERIALWATCHER_TX_DELTA_KEYFRAME);
+      lastkey = k;
+    }
+    else if (streams[k].find("1\"b\"2\"") != std::string::npos) {
+      CHECK(lastb < 0 || k - lastb == 4);
+      lastb = k;
+    }
+  }
+  CHECK(lastkey >= 0 && lastb >= 0);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//c is sent by the delta streams only in the stream after its change
+static void TestOnChange() {
+  std::vector<std::string> streams = Streams(T.Run(300));
+  size_t withc = 0;
+  for (size_t k = 0; k < streams.size(); k++) {
+    if (streams[k].compare(0, 2, "<+") == 0 && streams[k].find("2\"c\"") != std::string::npos) {
+      withc++;
+    }
+  }
+  CHECK_EQ(withc, (size_t)0);
+  c = 30;
+  streams = Streams(T.Run(300));
+  withc = 0;
+  for (size_t k = 0; k < streams.size(); k++) {
+    if (streams[k].find("2\"c\"30\"") != std::string::npos) {
+      withc++;
+      CHECK(k == 0 || streams[k].compare(0, 2, "<*") == 0); //the first stream after the change, then only the keyframes
+    }
+  }
+  CHECK(withc >= 1);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestEvery, TestOnChange)
@@ -0,0 +1,160 @@
+/*
+	cSerialWatcherRxTest.cpp
+
+	host tests of the rx command parser: ranges of each datatype, malformed commands, error codes
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+
+static int8_t i8 = 0;
+static uint8_t u8 = 0;
+static int16_t i16 = 0;
+static uint16_t u16 = 0;
+static int32_t i32 = 0;
+static uint32_t u32 = 0;
+static int64_t i64 = 0;
+static uint64_t u64 = 0;
+static float f = 0;
+static bool b = false;
+static char c = 'a';
+static char txt[SERIALWATCHER_RX_ARRAY_LENGTH] = ""; //the text written by the pc must fit
+static char tiny[4] = "";
+static int16_t adc[4] = {};
+
+static Fixture T;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//sends one command, returns RxError()
+static byte Command(const std::string &command) {
+  static bool mapped = false;
+  if (!mapped) {
+    T.W.Map(F("i8"), i8);    //0
+    T.W.Map(F("u8"), u8);    //1
+    T.W.Map(F("i16"), i16);  //2
+    T.W.Map(F("u16"), u16);  //3
+    T.W.Map(F("i32"), i32);  //4
+    T.W.Map(F("u32"), u32);  //5
+    T.W.Map(F("i64"), i64);  //6
+    T.W.Map(F("u64"), u64);  //7
+    T.W.Map(F("f"), f);      //8
+    T.W.Map(F("b"), b);      //9
+    T.W.Map(F("c"), c);      //10
+    T.W.Map(F("txt"), txt);  //11
+    T.W.Map(F("tiny"), tiny); //12
+    T.W.Map(F("adc"), adc);   //13
+    T.W.Update(); //the first Update() closes the map
+    mapped = true;
+  }
+  return T.Command(command);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestIntegerRanges() {
+  CHECK_EQ(Command("<q\"0\"-128>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(i8, -128);
+  CHECK_EQ(Command("<q\"0\"-129>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<q\"0\"128>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<d\"1\"255>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(u8, 255);
+  CHECK_EQ(Command("<d\"1\"256>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<d\"1\"-1>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<i\"2\"-32768>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(i16, -32768);
+  CHECK_EQ(Command("<i\"2\"32768>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<n\"3\"65535>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(u16, 65535);
+  CHECK_EQ(Command("<n\"3\"65536>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<l\"4\"-2147483648>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(i32, -2147483647 - 1);
+  CHECK_EQ(Command("<l\"4\"2147483648>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<u\"5\"4294967295>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(u32, 4294967295u);
+  CHECK_EQ(Command("<u\"5\"4294967296>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<r\"6\"-9223372036854775808>"), SERIALWATCHER_RX_OK);
+  CHECK(i64 == INT64_MIN);
+  CHECK_EQ(Command("<r\"6\"9223372036854775808>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<m\"7\"18446744073709551615>"), SERIALWATCHER_RX_OK);
+  CHECK(u64 == UINT64_MAX);
+  CHECK_EQ(Command("<m\"7\"18446744073709551616>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<i\"2\"12a>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<i\"2\"1.5>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<i\"2\">"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(i16, -32768); //unchanged by the errors
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestFloat() {
+  CHECK_EQ(Command("<f\"8\"-12.5>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(f, -12.5f);
+  CHECK_EQ(Command("<f\"8\"3.4e38>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(f, 3.4e38f);
+  CHECK_EQ(Command("<f\"8\"1e39>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<f\"8\"-1e39>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<f\"8\"1e999>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<f\"8\"inf>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<f\"8\"-INFINITY>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<f\"8\"nan>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<f\"8\">"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Command("<f\"8\"1.5x>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(f, 3.4e38f); //unchanged by the errors
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestOthers() {
+  CHECK_EQ(Command("<b\"9\"1>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(b, true);
+  CHECK_EQ(Command("<b\"9\"0>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(b, false);
+  CHECK_EQ(Command("<c\"10\"z>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(c, 'z');
+  CHECK_EQ(Command("<s\"11\"abcdefg>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(std::string(txt), std::string("abcdefg"));
+  CHECK_EQ(Command("<s\"11\">"), SERIALWATCHER_RX_OK); //a text can be empty
+  CHECK_EQ(std::string(txt), std::string(""));
+  CHECK_EQ(Command("<s\"12\"abc>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(std::string(tiny), std::string("abc"));
+  CHECK_EQ(Command("<s\"12\"abcd>"), SERIALWATCHER_RX_ERROR_OVERFLOW); //the terminator does not fit the mapped array
+  CHECK_EQ(std::string(tiny), std::string("abc"));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//numeric array: index:value,value ... within the array, else nothing is written
+static void TestArray() {
+  CHECK_EQ(Command("<i\"13\"1:10,11,12>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(adc[1], 10);
+  CHECK_EQ(adc[3], 12);
+  CHECK_EQ(Command("<i\"13\"2:20,21,22>"), SERIALWATCHER_RX_ERROR_INDEX); //beyond the array
+  CHECK_EQ(Command("<i\"13\"4:20>"), SERIALWATCHER_RX_ERROR_INDEX);
+  CHECK_EQ(Command("<i\"13\"65537:20>"), SERIALWATCHER_RX_ERROR_INDEX); //more than 16 bits, not wrapped to index 1
+  CHECK_EQ(Command("<i\"13\"60001:20>"), SERIALWATCHER_RX_ERROR_INDEX); //not truncated to index 6000
+  CHECK_EQ(Command("<i\"13\":20>"), SERIALWATCHER_RX_ERROR_INDEX);
+  CHECK_EQ(Command("<i\"13\"1:x>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(adc[1], 10);
+  CHECK_EQ(adc[2], 11);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestFormat() {
+  CHECK_EQ(Command("<i\"\"5>"), SERIALWATCHER_RX_ERROR_FORMAT); //no slot
+  CHECK_EQ(Command("<i\"x\"5>"), SERIALWATCHER_RX_ERROR_FORMAT);
+  CHECK_EQ(Command("<ii\"2\"5>"), SERIALWATCHER_RX_ERROR_FORMAT);
+  CHECK_EQ(Command("<i\"2\"5\"6>"), SERIALWATCHER_RX_ERROR_FORMAT);
+  CHECK_EQ(Command("<i\"14\"5>"), SERIALWATCHER_RX_ERROR_SLOT);
+  CHECK_EQ(Command("<d\"60001\"77>"), SERIALWATCHER_RX_ERROR_SLOT); //not truncated to slot 6000
+  CHECK_EQ(Command("<d\"600019\"55>"), SERIALWATCHER_RX_ERROR_SLOT);
+  CHECK_EQ(Command("<d\"65535\"55>"), SERIALWATCHER_RX_ERROR_SLOT);
+  CHECK_EQ(Command("<d\"000000000000000000001\"55>"), SERIALWATCHER_RX_OK); //leading zeros
+  CHECK_EQ(u8, 55);
+  CHECK_EQ(Command("<d\"1000000000000000000001\"66>"), SERIALWATCHER_RX_ERROR_SLOT);
+  CHECK_EQ(u8, 55);
+  CHECK_EQ(Command("<z\"2\"5>"), SERIALWATCHER_RX_ERROR_COMMAND);
+  CHECK_EQ(Command("<s\"11\"0123456789012345678901234567890>"), SERIALWATCHER_RX_ERROR_OVERFLOW);
+  CHECK_EQ(Command("garbage<i\"2\"77>"), SERIALWATCHER_RX_OK); //chars out of a command are ignored
+  CHECK_EQ(i16, 77);
+  CHECK_EQ(Command("<i\"2\"7"), SERIALWATCHER_RX_OK); //split over two Update()
+  CHECK_EQ(Command("8>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(i16, 78);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestIntegerRanges, TestFloat, TestOthers, TestArray, TestFormat)
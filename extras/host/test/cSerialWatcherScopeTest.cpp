@@ -0,0 +1,107 @@
+/*
+	cSerialWatcherScopeTest.cpp
+
+	host tests of the scope mode: sample order and loss accounting of the bursts, decoded with cSerialWatcherDecoder
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+
+static uint16_t counter = 0; //sampled, +1 each loop
+static int32_t other = 0;
+static char txt[8] = "";
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void MapAll(cSerialWatcher &W) {
+  W.Map(F("counter"), counter);
+  W.Map(F("other"), other);
+  W.Map(F("txt"), txt);
+  W.Update(); //the first Update() closes the map
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the sampled variable moves at each loop
+static void Sample() {
+  counter += 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//samples of the scope bursts, in order
+struct Burst {
+  uint16_t sequence;
+  uint16_t lost;
+  std::vector<uint16_t> samples;
+};
+static std::vector<Burst> Bursts(const std::string &tx) {
+  std::vector<Burst> bursts;
+  cSerialWatcherDecoder D;
+  D.Feed((const uint8_t *)tx.data(), tx.size(), [&](const cSerialWatcherRecord &Record) {
+    cSerialWatcherScope Scope;
+    if (cSerialWatcherDecoder::ParseScope(Record, Scope)) {
+      Burst burst = { Scope.sequence, Scope.lost, {} };
+      for (size_t k = 0; k + 1 < Scope.samples.size(); k += 2) {
+        burst.samples.push_back((uint16_t)(Scope.samples[k] | (Scope.samples[k + 1] << 8)));
+      }
+      bursts.push_back(burst);
+    }
+  });
+  CHECK_EQ(D.Errors(), 0u);
+  return bursts;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//every sample arrives once and in order, the samples dropped with the ring buffer full are counted, never silently skipped
+static void TestOrderAndLoss() {
+  Fixture T;
+  T.Each = Sample;
+  T.W.TxMode(SERIALWATCHER_TX_MODE_BINARY);
+  MapAll(T.W);
+  T.Loop(40); //binary mode active
+  CHECK_EQ(T.Command("<o\"1\"0>"), SERIALWATCHER_RX_OK);
+  uint16_t first = counter + 1; //first sampled value
+  T.Loop(200);
+  T.S.Room = 0; //serial port busy: the ring buffer fills up and the next samples are lost
+  T.Loop(300);
+  T.S.Room = -1;
+  T.Loop(400);
+  T.S.Send("<o\"0\"0>"); //stop, the samples still in the ring buffer are sent
+  T.Loop(400);
+  uint16_t last = counter;
+  std::vector<Burst> bursts = Bursts(T.S.Take());
+  CHECK(bursts.size() > 10);
+  uint32_t received = 0;
+  uint32_t gaps = 0; //samples missing between the received ones
+  uint16_t lost = 0;
+  uint16_t expected = first;
+  for (const Burst &burst : bursts) {
+    CHECK_EQ(burst.sequence, (uint16_t)received); //no burst missing
+    CHECK(burst.lost >= lost); //lost never goes back
+    lost = burst.lost;
+    for (uint16_t sample : burst.samples) {
+      CHECK(sample >= expected); //in order
+      gaps += sample - expected;
+      expected = sample + 1;
+      received += 1;
+    }
+    CHECK(gaps <= lost); //a gap only for the lost samples
+  }
+  CHECK(lost > 0);
+  CHECK_EQ(gaps, (uint32_t)lost); //all the lost samples are counted
+  CHECK(received + lost <= (uint32_t)(last - first + 1));
+  CHECK(received + lost >= (uint32_t)(last - first + 1) - 400); //only the samples after the stop are missing
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestReject() {
+  Fixture T;
+  T.Each = Sample;
+  MapAll(T.W);
+  CHECK_EQ(T.Command("<o\"1\"0>"), SERIALWATCHER_RX_ERROR_COMMAND); //ascii mode: the bursts could not be sent
+  CHECK_EQ(T.Command("<p\"0\"1><o\"1\"0>"), SERIALWATCHER_RX_OK); //the binary mode is selected first
+  CHECK_EQ(T.Command("<o\"1\"2>"), SERIALWATCHER_RX_ERROR_DATATYPE); //a text can't be sampled
+  CHECK_EQ(T.Command("<o\"1\"5>"), SERIALWATCHER_RX_ERROR_SLOT);
+  CHECK_EQ(T.Command("<o\"1\"65537>"), SERIALWATCHER_RX_ERROR_VALUE); //more than 16 bits, not wrapped to slot 1
+  CHECK_EQ(T.Command("<p\"0\"0><o\"0\"0>"), SERIALWATCHER_RX_OK); //the stop is always accepted
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestOrderAndLoss, TestReject)
@@ -0,0 +1,58 @@
+/*
+	cSerialWatcherSnapshotTest.cpp
+
+	host tests of the stream snapshot: the values copied at the stream start belong to the same loop, the ones that don't fit are read when sent
+	(built with SERIALWATCHER_TX_SNAPSHOT_BUFFER 16)
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+#include <vector>
+
+static uint32_t loops = 0;
+static uint32_t a = 0;
+static uint32_t b = 0;
+static uint32_t c = 0;
+static uint32_t d = 0;
+static uint32_t late = 0; //beyond the 16 bytes of the snapshot
+
+static Fixture T;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//all the variables move together at each loop
+static void Move() {
+  loops++;
+  a = b = c = d = late = loops;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//values of a whole ascii stream <*slot"name"value"features; ... *>, in slot order
+static std::vector<std::string> Values(const std::string &stream) {
+  std::vector<std::string> values;
+  for (size_t k = 2; k < stream.size() && stream.compare(k, 2, "*>") != 0; k = stream.find(';', k) + 1) {
+    size_t value = stream.find('"', stream.find('"', k) + 1) + 1;
+    values.push_back(stream.substr(value, stream.find('"', value) - value));
+  }
+  return values;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestSameLoop() {
+  T.W.Map(F("a"), a);
+  T.W.Map(F("b"), b);
+  T.W.Map(F("c"), c);
+  T.W.Map(F("d"), d);
+  T.W.Map(F("late"), late);
+  T.W.Update(); //the first Update() closes the map
+  T.Each = Move;
+  std::string tx = T.Run(200);
+  std::string stream = LastStream(tx);
+  std::vector<std::string> values = Values(stream);
+  CHECK_EQ(values.size(), (size_t)5);
+  CHECK_EQ(values[1], values[0]);
+  CHECK_EQ(values[2], values[0]);
+  CHECK_EQ(values[3], values[0]);
+  CHECK(std::stoul(values[4]) > std::stoul(values[0])); //one element for each Update(): read some loops later
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestSameLoop)
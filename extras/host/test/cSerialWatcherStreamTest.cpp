@@ -0,0 +1,68 @@
+/*
+	cSerialWatcherStreamTest.cpp
+
+	host round-trip tests of the whole tx stream across tx mode changes: board (cSerialWatcher) -> pc (cSerialWatcherStream)
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+
+static int16_t i16 = -1234;
+static uint32_t u32 = 4000000000u;
+static float f = 2.5f;
+static char txt[16] = "hello";
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void MapAll(cSerialWatcher &W) {
+  W.Map(F("i16"), i16);
+  W.Map(F("u32"), u32);
+  W.Map(F("f"), f);
+  W.Map(F("txt"), txt);
+  W.Update(); //the first Update() closes the map
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//every switch of the schema session between ascii and binary starts with a schema frame, so the pc never sees a value frame without names
+static void TestSchemaModeSwitch() {
+  Fixture T;
+  cSerialWatcherStream Pc;
+  MapAll(T.W);
+  const byte modes[] = { SERIALWATCHER_TX_MODE_SCHEMA, SERIALWATCHER_TX_MODE_SCHEMA | SERIALWATCHER_TX_MODE_BINARY, SERIALWATCHER_TX_MODE_SCHEMA,
+    SERIALWATCHER_TX_MODE_SCHEMA | SERIALWATCHER_TX_MODE_BINARY | SERIALWATCHER_TX_MODE_DELTA, SERIALWATCHER_TX_MODE_SCHEMA | SERIALWATCHER_TX_MODE_DELTA };
+  for (byte mode : modes) {
+    T.W.TxMode(mode);
+    for (int k = 0; k < 4; k++) {
+      i16 += 1;
+      Feed(Pc, T.Run(40));
+    }
+    CHECK_EQ(Pc.Errors(), 0u);
+    CHECK_EQ(Value(Pc, 0), std::to_string(i16));
+    CHECK_EQ(Pc.Table()[0].name, std::string("i16"));
+  }
+  CHECK_EQ(Value(Pc, 1), std::string("4000000000"));
+  CHECK_EQ(Value(Pc, 3), std::string("hello"));
+  CHECK(Pc.Streams() >= 20);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the values written with cSerialWatcherCommand come back in the stream
+static void TestCommandRoundTrip() {
+  Fixture T;
+  cSerialWatcherStream Pc;
+  MapAll(T.W);
+  T.S.Send(cSerialWatcherCommand::TxMode(SERIALWATCHER_TX_MODE_BINARY));
+  T.S.Send(cSerialWatcherCommand::Write(0, SERIALWATCHER_DATATYPE_int16_t, "-7"));
+  T.S.Send(cSerialWatcherCommand::Write(2, SERIALWATCHER_DATATYPE_float, "0.75"));
+  T.S.Send(cSerialWatcherCommand::Write(3, SERIALWATCHER_DATATYPE_achar, "world"));
+  Feed(Pc, T.Run(80));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_OK);
+  CHECK_EQ(Value(Pc, 0), std::string("-7"));
+  CHECK_EQ(Value(Pc, 2).substr(0, 4), std::string("0.75"));
+  CHECK_EQ(Value(Pc, 3), std::string("world"));
+  CHECK_EQ(Pc.Errors(), 0u);
+  i16 = -1234;
+  f = 2.5f;
+  strcpy(txt, "hello");
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestSchemaModeSwitch, TestCommandRoundTrip)
@@ -0,0 +1,72 @@
+/*
+	cSerialWatcherSubscribeTest.cpp
+
+	host tests of the subscription commands (list and bitmap)
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+
+static int16_t v0 = 10;
+static int16_t v1 = 11;
+static int16_t v2 = 12;
+static int16_t v3 = 13;
+
+static Fixture T;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//sends the commands and returns the first whole stream after them
+static std::string Stream(const std::string &commands) {
+  static bool mapped = false;
+  if (!mapped) {
+    T.W.Map(F("v0"), v0);
+    T.W.Map(F("v1"), v1);
+    T.W.Map(F("v2"), v2);
+    T.W.Map(F("v3"), v3);
+    T.W.Update(); //the first Update() closes the map
+    mapped = true;
+  }
+  T.S.Send(commands);
+  return FirstStream(T.Run(80));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestList() {
+  CHECK_EQ(Stream("<k\"0\"1,3>"), std::string("<*1\"v1\"11\"3;3\"v3\"13\"3;*>"));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_OK);
+  CHECK_EQ(Stream("<k\"1\"0-1>"), std::string("<*0\"v0\"10\"3;1\"v1\"11\"3;3\"v3\"13\"3;*>"));
+  CHECK_EQ(Stream("<k\"2\"1>"), std::string("<*0\"v0\"10\"3;3\"v3\"13\"3;*>"));
+  CHECK_EQ(Stream("<k\"0\"*>"), std::string("<*0\"v0\"10\"3;1\"v1\"11\"3;2\"v2\"12\"3;3\"v3\"13\"3;*>"));
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//a slot number too big for 16 bits is rejected, not truncated, and the subscription is unchanged
+static void TestErrors() {
+  Stream("<k\"0\"2>");
+  CHECK_EQ(Stream("<k\"0\"60001>"), std::string("<*2\"v2\"12\"3;*>")); //not truncated to 6000
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_ERROR_SLOT);
+  CHECK_EQ(Stream("<k\"0\"65536>"), std::string("<*2\"v2\"12\"3;*>"));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Stream("<k\"0\"1,1000000000000000000002>"), std::string("<*2\"v2\"12\"3;*>"));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Stream("<k\"0\"0-600019>"), std::string("<*2\"v2\"12\"3;*>"));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Stream("<k\"0\"65535>"), std::string("<*2\"v2\"12\"3;*>"));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_ERROR_SLOT);
+  CHECK_EQ(Stream("<k\"0\"3-1>"), std::string("<*2\"v2\"12\"3;*>"));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(Stream("<k\"3\"1>"), std::string("<*2\"v2\"12\"3;*>"));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_ERROR_VALUE);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestBitmap() {
+  CHECK_EQ(Stream("<K\"0\"09>"), std::string("<*0\"v0\"10\"3;3\"v3\"13\"3;*>"));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_OK);
+  CHECK_EQ(Stream("<K\"8\"FF>"), std::string("<*0\"v0\"10\"3;3\"v3\"13\"3;*>"));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_ERROR_SLOT);
+  CHECK_EQ(Stream("<K\"0\"0G>"), std::string("<*0\"v0\"10\"3;3\"v3\"13\"3;*>"));
+  CHECK_EQ(T.W.RxError(), SERIALWATCHER_RX_ERROR_VALUE);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestList, TestErrors, TestBitmap)
@@ -0,0 +1,111 @@
+/*
+	cSerialWatcherTest.cpp
+
+	host tests of the ascii stream and of the rx commands (default library configuration)
+*/
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "Fixture.h"
+
+static bool b = true;
+static int16_t i16 = -1234;
+static float f = 3.5f;
+static char txt[16] = "hello";
+static uint64_t u64 = 18446744073709551615ull;
+static int64_t i64 = -42;
+static uint8_t ro = 7;
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void MapAll(cSerialWatcher &W) {
+  W.Map(F("b"), b);
+  W.Map(F("i16"), i16);
+  W.Map(F("f"), f);
+  W.Map(F("txt"), txt);
+  W.Map(F("u64"), u64);
+  W.Map(F("i64"), i64);
+  W.Map(F("ro"), ro, true);
+  W.Text(F("hi"));
+  W.Update(); //the first Update() closes the map
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestAsciiFrame() {
+  Fixture T;
+  MapAll(T.W);
+  CHECK_EQ(FirstStream(T.Run(12)), std::string("<*0\"b\"1\"0;1\"i16\"-1234\"3;2\"f\"3.50\"9;3\"txt\"hello\"11;4\"u64\"18446744073709551615\"8;")
+    + "5\"i64\"-42\"7;6\"ro\"7\"66;7\"hi\"\"12;*>");
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestStreamPeriod() {
+  Fixture T;
+  MapAll(T.W);
+  std::string out = T.Run(SERIALWATCHER_TX_STREAM_PERIOD - 1);
+  CHECK(out.find("*>") != std::string::npos);
+  CHECK(out.find("<*", 1) == std::string::npos); //the next stream waits for the period
+  CHECK(T.Run(4).find("<*") == 0);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestNonBlocking() {
+  Fixture T;
+  MapAll(T.W);
+  T.Loop(1); //the library sees availableForWrite() working
+  T.S.Room = 0;
+  T.Loop(10);
+  CHECK_EQ(T.S.Tx, std::string("<*")); //no room: nothing is written, nothing is lost
+  T.S.Room = -1;
+  CHECK(T.Run(12).find("<*0\"b\"1\"0;1\"i16\"") == 0);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestRxWrite() {
+  Fixture T;
+  MapAll(T.W);
+  CHECK_EQ(T.Command("<i\"1\"-12>"), SERIALWATCHER_RX_OK);
+  CHECK_EQ(i16, -12);
+  T.Command("<f\"2\"-0.25><b\"0\"0>");
+  CHECK_EQ(f, -0.25f);
+  CHECK_EQ(b, false);
+  T.Command("<s\"3\"world>");
+  CHECK_EQ(std::string(txt), std::string("world"));
+  T.Command("<m\"4\"12345678901234567890>");
+  CHECK_EQ(u64, 12345678901234567890ull);
+  i16 = -1234; f = 3.5f; b = true; strcpy(txt, "hello"); u64 = 18446744073709551615ull;
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static void TestRxErrors() {
+  Fixture T;
+  MapAll(T.W);
+  CHECK_EQ(T.Command("<d\"6\"1>"), SERIALWATCHER_RX_ERROR_READONLY);
+  CHECK_EQ(ro, 7);
+  CHECK_EQ(T.Command("<l\"1\"5>"), SERIALWATCHER_RX_ERROR_DATATYPE);
+  CHECK_EQ(T.Command("<i\"40\"5>"), SERIALWATCHER_RX_ERROR_SLOT);
+  CHECK_EQ(T.Command("<i\"1\"40000>"), SERIALWATCHER_RX_ERROR_VALUE);
+  CHECK_EQ(T.Command("<x\"1\"5>"), SERIALWATCHER_RX_ERROR_COMMAND);
+  CHECK_EQ(T.Command("<i\"1>"), SERIALWATCHER_RX_ERROR_FORMAT);
+  CHECK_EQ(i16, -1234);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//registration table longer than 255 slots
+static void TestFlashTable() {
+  static const int count = 290;
+  static int16_t values[count];
+  static char names[count][8];
+  static cSerialWatcherSlot table[count]; //PROGMEM on the board, plain memory on the host
+  for (int k = 0; k < count; k++) {
+    values[k] = (int16_t)k;
+    snprintf(names[k], sizeof(names[k]), "v%d", k);
+    table[k] = { names[k], &values[k], &cSerialWatcherTraits<int16_t>::codec, SERIALWATCHER_DATATYPE_int16_t };
+  }
+  Fixture T;
+  T.W.Map(table, count);
+  T.W.Update(); //the first Update() closes the map
+  std::string out = T.Run(count + 4);
+  CHECK(out.find(";289\"v289\"289\"3;*>") != std::string::npos);
+  CHECK(out.find("*1*") == std::string::npos);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+CHECK_MAIN(TestFlashTable, TestAsciiFrame, TestStreamPeriod, TestNonBlocking, TestRxWrite, TestRxErrors)
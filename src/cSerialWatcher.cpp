@@ -1,94 +1,312 @@
 /*
-	cSerialWatcher.h
-
-	a fast lightweight real time library to monitor and modify arduino variables via serial usb
-	this library is compatible with arduino unoR3 (atmega328p) and all the shields based on esp8266
-  
-
-  Instructions
-
-	1) include SerialWatcher source library
-	   #include "cSerialWatcher.h"
-	   
-	2) create a SerialWatcher instance
-		cSerialWatcher SerialWatcher(Serial);
-
-  3) init Serial communication inside the setup() routine
-	   Serial.begin(115200);
-
-	4) map the variables to watch in the GUI inside the main loop()
-     SerialWatcher.Map(F("Name_That_You_Prefer"), GlobalVariableDeclarationName(Variable_Name), Readonly(bool));
-
-  5) call the update instruction to refresh them all at each loop scan (only once, in the loop)
-     SerialWatcher.Update();
-
-  6) upload the software to the shield and then run SerialWatcherApp on your computer to monitor/edit the mapped global variables
-		 https://github.com/lozziboy/arduino-serial-watcher-app
-
-
-  Additional info
-
-  > readonly parameter is optional (default value is false)
-
-  > the following instuction add empty spaces between lines 
-      SerialWatcher.EmptySpace();
-
-  > the following instuction add custome texts
-      SerialWatcher.Text(F("My custom text"));
-
-  > SerialWatcher class memory occupation can be reduced/exdended based on your needs! 
-	  Just increase/decrease the number of monitorning slots based how many variables to be monitored
-      #define SERIALWATCHER_TX_MAX_VALUES 5
-
-  Usage example
-
-      SerialWatcher.Map(F("Name"), var, false);         //  | F("name") | variable | readonly |
-      SerialWatcher.EmptySpace();
-      SerialWatcher.Text(F("Write here your text"));
-  
-
-	Supported Data-Types 
-	> bool:             8 bit (1 byte) two possible values, true or false
-    > int8_t:           8 bit (1 byte) unsigned number, from -128 to 127
-    > uint8_t:          8 bit (1 byte) unsigned number, from 0 to 255
-    > int16_t:          16 bit (2 byte), from -32'768 to 32'767
-    > uint16_t:         16 bit (2 byte) unsigned number, from 0 to 65,535
-    > int32_t:          32 bit (4 bytes), from -2'147'483'648 to 2'147'483'647
-    > uint32_t:         32 bit (4 bytes) unsigned number from 0 to 4'294'967'295
-    > int64_t:          64 bit (8 bytes), from -9'223'372'036'854'775'808 to 9'223'372'036'854'775'807
-    > uint64_t:         64 bit (8 bytes) unsigned number, from 0 to 18'446'744'073'709'551'615   
-    > float:            32 bits (4 bytes) floating-point numbers, from -3.4028235E+38 to 3.4028235E+38
-    > char:             8 bits (1 byte), from -128 to 127
-    > array of chars:   8 bits (1 byte) each slot of the array
-    > flashstrings:     8 bit (1 byte) is a pointer of a string stored in flash (program) memory instead of SRAM
-    > text/empty space: 8 bit (1 byte) stored in a pointer of a string stored in flash (program) memory instead of SRAM
+	cSerialWatcher.cpp
 
+	implementation of the cSerialWatcher class, the instructions, the configuration and the protocol are documented in cSerialWatcher.h
 */
 
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
 #include "Arduino.h"
 #include "cSerialWatcher.h"
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//rx code of each writable datatype, indexed by SERIALWATCHER_DATATYPE_*
+static const char RxCodes[12] PROGMEM = {
+  SERIALWATCHER_RX_CODE_STREAM_bool, SERIALWATCHER_RX_CODE_STREAM_int8_t, SERIALWATCHER_RX_CODE_STREAM_uint8_t, 
+  SERIALWATCHER_RX_CODE_STREAM_int16_t, SERIALWATCHER_RX_CODE_STREAM_uint16_t, SERIALWATCHER_RX_CODE_STREAM_int32_t, 
+  SERIALWATCHER_RX_CODE_STREAM_uint32_t, SERIALWATCHER_RX_CODE_STREAM_int64_t, SERIALWATCHER_RX_CODE_STREAM_uint64_t, 
+  SERIALWATCHER_RX_CODE_STREAM_float, SERIALWATCHER_RX_CODE_STREAM_char, SERIALWATCHER_RX_CODE_STREAM_achar
+};
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_BINARY || SERIALWATCHER_TX_DELTA || SERIALWATCHER_TX_NUMARRAYS || SERIALWATCHER_RX_BATCH || SERIALWATCHER_TX_SNAPSHOT || SERIALWATCHER_TX_COMPACT || SERIALWATCHER_TX_ALARM
+//number of bytes of each datatype value, indexed by SERIALWATCHER_DATATYPE_* (0 = variable length)
+static const byte DataTypeSize[16] PROGMEM = {
+  sizeof(bool), sizeof(int8_t), sizeof(uint8_t), sizeof(int16_t), sizeof(uint16_t), sizeof(int32_t), sizeof(uint32_t), 
+  sizeof(int64_t), sizeof(uint64_t), sizeof(float), sizeof(char), 0, 0, sizeof(uint16_t), sizeof(int16_t), 0
+};
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//value codecs of the traits without a template (see cSerialWatcher.h)
+const cSerialWatcherCodec cSerialWatcherTraits<bool>::codec = { cSerialWatcherTraits<bool>::Format, cSerialWatcherTraits<bool>::Parse };
+const cSerialWatcherCodec cSerialWatcherTraits<float>::codec = { cSerialWatcherTraits<float>::Format, cSerialWatcherTraits<float>::Parse };
+const cSerialWatcherCodec cSerialWatcherTraits<char>::codec = { cSerialWatcherTraits<char>::Format, cSerialWatcherTraits<char>::Parse };
+//value codecs of the text datatypes
+static bool TextParse(const char *src, void *value) {
+  strcpy((char*)value, src); //the length is checked against the mapped size (see RxWrite())
+  return true;
+}
+static const cSerialWatcherCodec TextCodec = { NULL, TextParse }; //the text is sent by the tx text part
+static const cSerialWatcherCodec FlashCodec = { NULL, NULL };     //readonly text
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_SUBSCRIBE || SERIALWATCHER_SCOPE || SERIALWATCHER_TX_NUMARRAYS
+//decimal slot number or array index of an rx value, src is moved after the digits (false = no digits or more than 16 bits)
+static bool ListNumber(const char *&src, uint16_t &number) {
+  if (*src < '0' || *src > '9') {
+    return false;
+  }
+  number = 0;
+  while (*src >= '0' && *src <= '9') {
+    if (number > (0xFFFF - (*src - '0')) / 10) {
+      return false;
+    }
+    number = number * 10 + (*src - '0');
+    src++;
+  }
+  return true;
+}
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//"00" "01" ... "99", used to format two digits at a time
+static const char DigitPairs[200] PROGMEM = {
+  '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+  '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+  '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+  '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+  '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+  '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+  '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+  '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+  '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+  '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_COMPACT
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//LEB128 varint of an integer value (zigzag for the signed datatypes: 0, -1, 1, -2 ... become 0, 1, 2, 3 ...), returns the number of bytes (max 10)
+static byte CompactVarint(byte *dst, const void *value, byte datatype) {
+  byte size = pgm_read_byte(&DataTypeSize[datatype]);
+  bool sign = (datatype == SERIALWATCHER_DATATYPE_int8_t || datatype == SERIALWATCHER_DATATYPE_int16_t || 
+               datatype == SERIALWATCHER_DATATYPE_int32_t || datatype == SERIALWATCHER_DATATYPE_int64_t);
+  byte len = 0;
+  if (size > 4) { //64 bit math only when needed
+    uint64_t v;
+    memcpy(&v, value, sizeof(v));
+    if (sign) {
+      v = (v << 1) ^ (uint64_t)((int64_t)v >> 63);
+    }
+    while (v >= 0x80) {
+      dst[len++] = (byte)v | 0x80;
+      v >>= 7;
+    }
+    dst[len++] = (byte)v;
+    return len;
+  }
+  uint32_t v = 0;
+  memcpy(&v, value, size); //all the supported boards are little-endian
+  if (sign) {
+    if (size < 4 && (v >> (size * 8 - 1)) != 0) {
+      v |= 0xFFFFFFFFUL << (size * 8); //sign extension
+    }
+    v = (v << 1) ^ (uint32_t)((int32_t)v >> 31);
+  }
+  while (v >= 0x80) {
+    dst[len++] = (byte)v | 0x80;
+    v >>= 7;
+  }
+  dst[len++] = (byte)v;
+  return len;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_NUMARRAYS
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//PackBits of the values in src (total bytes, values of size bytes), up to room bytes in dst
+//every run ends on a value boundary when it crosses one, so the record is cut after the last whole value that fits
+//returns the number of bytes written, values = number of packed values
+static byte CompactPack(byte *dst, byte room, const byte *src, uint32_t total, byte size, uint16_t &values) {
+  uint32_t p = 0; //input position
+  byte out = 0;
+  uint32_t cp = 0; //last value boundary ...
+  byte cpout = 0;  //... and the output at that point
+  while (p < total) {
+    uint32_t n = 1;
+    bool run;
+    while (p + n < total && n < 128 && src[p + n] == src[p]) {
+      n++;
+    }
+    run = (n >= 3);
+    if (!run) { //literal bytes up to the next run of 3
+      n = 0;
+      while (p + n < total && n < 128 && !(p + n + 2 < total && src[p + n] == src[p + n + 1] && src[p + n] == src[p + n + 2])) {
+        n++;
+      }
+    }
+    if (!run && out + 1 + n > room) {
+      n = (out + 1 < room) ? room - out - 1 : 0; //as many literal bytes as fit
+    }
+    uint32_t end = (p + n) / size * size;
+    if (end > p && end != p + n) {
+      n = end - p; //stop on the value boundary, the rest is the next run
+    }
+    if (n == 0 || out + (run ? 2 : 1 + n) > room) {
+      break;
+    }
+    if (run && n > 1) {
+      dst[out++] = (byte)(1 - (int)n);
+      dst[out++] = src[p];
+    }
+    else {
+      dst[out++] = (byte)(n - 1);
+      memcpy(&dst[out], &src[p], n);
+      out += n;
+    }
+    p += n;
+    if (p % size == 0) {
+      cp = p;
+      cpout = out;
+    }
+  }
+  values = cp / size;
+  return cpout;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#endif
+#endif
+#if SERIALWATCHER_TX_FLOATENC
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//IEEE-754 half precision of a float, rounded to nearest even (bit math only, overflow = infinity, tiny values = subnormal or zero)
+static uint16_t FloatToHalf(float f) {
+  uint32_t x;
+  memcpy(&x, &f, sizeof(x));
+  uint16_t sign = (uint16_t)(x >> 16) & 0x8000;
+  int16_t exp = (int16_t)((x >> 23) & 0xFF) - 127 + 15;
+  uint32_t mant = x & 0x7FFFFFUL;
+  if (((x >> 23) & 0xFF) == 0xFF) {
+    return sign | 0x7C00 | (mant != 0 ? 0x200 : 0); //infinity, nan
+  }
+  if (exp >= 31) {
+    return sign | 0x7C00; //overflow
+  }
+  byte shift = 13;
+  uint16_t h = sign;
+  if (exp > 0) {
+    h |= (uint16_t)exp << 10;
+  }
+  else { //subnormal
+    if (exp < -10) {
+      return sign; //zero
+    }
+    mant |= 0x800000UL;
+    shift = 14 - exp;
+  }
+  h |= (uint16_t)(mant >> shift);
+  uint32_t rest = mant & ((1UL << shift) - 1);
+  uint32_t half = 1UL << (shift - 1);
+  if (rest > half || (rest == half && (h & 1) != 0)) {
+    h++; //the carry into the exponent is still the right value
+  }
+  return h;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
 cSerialWatcher::cSerialWatcher(Stream &serial) { //constructor
   _serial = &serial; //to store the pointer in a variable & is still needed to get the address
   indexglobal = 0;
-  _mem = B00000000;
-  TxIdx = 0;
+  SlotCount = 0;
+  #if SERIALWATCHER_TX_DYNAMIC
+  SlotCapacity = 0;
+  ArrayNames = NULL;
+  ArrayValues = NULL;
+  ArrayFeatures = NULL;
+  ArrayCodecs = NULL;
+  ArrayTextSizes = NULL;
+  #if SERIALWATCHER_TX_DELTA
+  ArrayShadow = NULL;
+  #endif
+  #if SERIALWATCHER_TX_REFRESH
+  ArrayRefresh = NULL;
+  #endif
+  #if SERIALWATCHER_TX_SUBSCRIBE
+  ArraySubscribed = NULL;
+  #endif
+  #endif
+  _mem = 0x00;
+  TxState = SERIALWATCHER_TX_STATE_START;
+  TxSlot = 0;
+  TxSlotEnd = 0;
+  _page = 0;
+  _pagesize = 0;
+  TxLen = 0;
+  TxPos = 0;
+  TxSent = 0;
+  _txroom = 0;
+  _txbudgetus = SERIALWATCHER_TX_BUDGET_US;
+  _txbudgetbytes = SERIALWATCHER_TX_BUDGET_BYTES;
+  TxPart = 0;
+  TxPartPos = 0;
+  _txmode = SERIALWATCHER_TX_MODE_ASCII;
+  _txmoderequest = SERIALWATCHER_TX_MODE_ASCII;
+  #if SERIALWATCHER_TX_DELTA
+  _txframe = 0;
+  _deadbands = 0;
+  #endif
+  #if SERIALWATCHER_TX_REFRESH
+  _txcount = 0;
+  #endif
+  #if SERIALWATCHER_TX_NUMARRAYS
+  _numarrays = 0;
+  #endif
+  #if SERIALWATCHER_TX_FLOATENC
+  _floatencs = 0;
+  #endif
+  #if SERIALWATCHER_TX_ALARM
+  _alarms = 0;
+  _alarmstate = 0;
+  _alarmpending = 0;
+  _alarmreport = 0;
+  _alarmheld = 0;
+  _alarmturn = false;
+  #endif
+  #if SERIALWATCHER_TX_SNAPSHOT
+  _snapshotend = 0; //empty
+  _snapshotslot = 0;
+  _snapshotpos = 0;
+  #endif
+  #if SERIALWATCHER_TX_SCHEMA
+  _schemaversion = 0;
+  _schemasent = 0;
+  #endif
+  #if SERIALWATCHER_SCOPE
+  _scopedecimation = 0;
+  _scopeslots = 0;
+  _scopecount = 0;
+  #endif
   // clear data buffer for the next rx
   RxBuffer[0] = '\0';
+  RxLen = 0;
+  RxFields = 0;
+  RxType = '\0';
+  RxSlot = 0xFFFF;
+  RxStatus = SERIALWATCHER_RX_OK;
+  _rxerror = SERIALWATCHER_RX_OK;
+  #if SERIALWATCHER_RX_BATCH
+  RxPairs = 0;
+  _batchcount = 0;
+  _batchseq = 0;
+  _batchresult = SERIALWATCHER_RX_OK;
+  _batchstate = SERIALWATCHER_RX_BATCH_IDLE;
+  #endif
+  #if SERIALWATCHER_PROFILE
+  _proftxus = 0;
+  _profrxus = 0;
+  _profmaxus = 0;
+  _profmaxrun = 0;
+  memset(_profloop, 0, sizeof(_profloop));
+  _proftxbytes = 0;
+  _profrxbytes = 0;
+  _proffps = 0;
+  _profframes = 0;
+  _proferrors = 0;
+  _profoverflows = 0;
+  _proffree = 0;
+  _proflast = 0;
+  _profwindow = 0;
+  #endif
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
 bool cSerialWatcher::CheckIdx() {
-  //first map done -> update index and exit
+  //registration done -> old style Map() called at every loop: only the map cursor is updated, once at every transmission cycle
   if ((_mem & SERIALWATCHER_MEMO_FISTMAPDONE) == SERIALWATCHER_MEMO_FISTMAPDONE) {
-    //update index only once at every transmission cycle
-    if (TxIdx == 0) {
-      if (indexglobal >=  SERIALWATCHER_TX_MAX_VALUES-1) {
-        _mem = _mem | SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR; //SET
-      }
-      else {
-        indexglobal += 1;
-      }
+    if (TxState == SERIALWATCHER_TX_STATE_START && indexglobal < SlotCount) {
+      indexglobal += 1;
     }
     return false;
   }
@@ -97,9 +315,64 @@ bool cSerialWatcher::CheckIdx() {
     _mem = _mem | SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR; //SET
     return false;
   }
+  #if SERIALWATCHER_TX_DYNAMIC
+  //out of memory is reported as the maximum number exceeded
+  if (indexglobal >= SlotCapacity && !SlotGrow()) {
+    _mem = _mem | SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR; //SET
+    return false;
+  }
+  #endif
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_DYNAMIC
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//grow one slot array from used to count values, the new values are zeroed (realloc leaves them undefined)
+//the array is unchanged when the memory is not available
+template <typename T> static bool SlotResize(T *&array, uint16_t used, uint16_t count) {
+  T *p = (T*)realloc(array, count * sizeof(T));
+  if (p == NULL) {
+    return false;
+  }
+  memset(p + used, 0, (count - used) * sizeof(T));
+  array = p;
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Allocate the next block of slots -
+// the slots are mapped once in the setup routine, so the arrays grow only there and the heap is not fragmented during the loop
+//
+bool cSerialWatcher::SlotGrow() {
+  uint16_t capacity = SlotCapacity + SERIALWATCHER_TX_DYNAMIC_BLOCK;
+  if (capacity > SERIALWATCHER_TX_MAX_VALUES) {
+    capacity = SERIALWATCHER_TX_MAX_VALUES;
+  }
+  if (!SlotResize(ArrayNames, SlotCapacity, capacity) || !SlotResize(ArrayValues, SlotCapacity, capacity) || 
+      !SlotResize(ArrayFeatures, SlotCapacity, capacity) || !SlotResize(ArrayCodecs, SlotCapacity, capacity) || 
+      !SlotResize(ArrayTextSizes, SlotCapacity, capacity)) {
+    return false;
+  }
+  #if SERIALWATCHER_TX_DELTA
+  if (!SlotResize(ArrayShadow, SlotCapacity, capacity)) {
+    return false;
+  }
+  #endif
+  #if SERIALWATCHER_TX_REFRESH
+  if (!SlotResize(ArrayRefresh, SlotCapacity, capacity)) {
+    return false;
+  }
+  #endif
+  #if SERIALWATCHER_TX_SUBSCRIBE
+  if (!SlotResize(ArraySubscribed, (SlotCapacity + 7) / 8, (capacity + 7) / 8)) {
+    return false;
+  }
+  #endif
+  SlotCapacity = capacity;
   return true;
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
 bool cSerialWatcher::CheckValidName(const __FlashStringHelper *Name) {
   if (Name != nullptr) {
     if (IsTextValid(Name)) {
@@ -115,16 +388,18 @@ bool cSerialWatcher::CheckValidName(const __FlashStringHelper *Name) {
   return false;
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//bool
-void cSerialWatcher::Map(const __FlashStringHelper *Name, bool &Value, bool readonly) {
-  //check first map mand manage if maximum number of transmittable variables has been exceeded
+//bool, integers and float (see the Map template)
+void cSerialWatcher::MapSlot(const __FlashStringHelper *Name, void *Value, byte datatype, const cSerialWatcherCodec *codec, bool readonly) {
+  //check first map and manage if maximum number of transmittable variables has been exceeded
   if (!CheckIdx()) {
     return; //exit
   }
   //map the value
-  ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
+  ArrayValues[indexglobal] = Value;
+  ArrayCodecs[indexglobal] = codec;
+  ArrayTextSizes[indexglobal] = 0; //see the array of chars Map()
   //map the data type
-  ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_bool;
+  ArrayFeatures[indexglobal] = datatype;
   //map the name
   if (CheckValidName(Name)) {
       ArrayNames[indexglobal] = Name;
@@ -133,396 +408,424 @@ void cSerialWatcher::Map(const __FlashStringHelper *Name, bool &Value, bool read
   if (readonly) {
     ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
   }
+  //check for valid value (cached in the features, see CheckValue())
+  CheckValue(indexglobal);
+  #if SERIALWATCHER_TX_REFRESH
+  ArrayRefresh[indexglobal] = 0; //every stream
+  #endif
+  #if SERIALWATCHER_TX_SUBSCRIBE
+  ArraySubscribed[indexglobal >> 3] |= (byte)(1 << (indexglobal & 7)); //subscribed
+  #endif
   //
   indexglobal += 1;
+  SlotCount = indexglobal;
+  #if SERIALWATCHER_TX_SCHEMA
+  _schemaversion += 1; //the mapping has changed
+  #endif
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//int8_t
-void cSerialWatcher::Map(const __FlashStringHelper *Name, int8_t &Value, bool readonly) {
-  //check first map and manage if maximum number of transmittable variables has been exceeded
-  if (!CheckIdx()) {
-    return; //exit
-  }
-  //map the value
-  ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
-  //map the data type
-  ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_int8_t;
-  //map the name
-  if (CheckValidName(Name)) {
-      ArrayNames[indexglobal] = Name;
-  }
-  //read only
-  if (readonly) {
-    ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
+//array of char - pointers to the first element of the array char
+void cSerialWatcher::Map(const __FlashStringHelper *Name, char *Value, size_t size, bool readonly) { 
+  cSerialWatcherIndex count = SlotCount;
+  MapSlot(Name, Value, SERIALWATCHER_DATATYPE_achar, &TextCodec, readonly);
+  if (SlotCount != count) {
+    ArrayTextSizes[SlotCount-1] = (size > 0xFF) ? 0xFF : (byte)size;
   }
-  //
-  indexglobal += 1;
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//uint8_t
-void cSerialWatcher::Map(const __FlashStringHelper *Name, uint8_t &Value, bool readonly) {
-  //check first map and manage if maximum number of transmittable variables has been exceeded
-  if (!CheckIdx()) {
-    return; //exit
-  }
-  //map the value
-  ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
-  //map the data type
-  ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_uint8_t;
-  //map the name
-  if (CheckValidName(Name)) {
-      ArrayNames[indexglobal] = Name;
+//flashstring
+void cSerialWatcher::Map(const __FlashStringHelper *Name, const __FlashStringHelper *Value) {
+  //check for valid pointer (value)
+  if (Value == nullptr) {
+    Value = F("");
   }
-  //read only
-  if (readonly) {
-    ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
+  //old style Map() called at every loop: the pointed address in flash memory could change
+  if ((_mem & SERIALWATCHER_MEMO_FISTMAPDONE) == SERIALWATCHER_MEMO_FISTMAPDONE) {
+    if (TxState == SERIALWATCHER_TX_STATE_START && indexglobal < SlotCount) {
+      if ((ArrayFeatures[indexglobal] & SERIALWATCHER_FEATURES_MASK_DATATYPE) == SERIALWATCHER_DATATYPE_flashstring && ArrayValues[indexglobal] != Value) {
+        ArrayValues[indexglobal] = (void*) Value;
+        CheckValue(indexglobal);
+      }
+      indexglobal += 1;
+    }
+    return;
   }
-  //
-  indexglobal += 1;
+  MapSlot(Name, (void*) Value, SERIALWATCHER_DATATYPE_flashstring, &FlashCodec, false);
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//int16_t
-void cSerialWatcher::Map(const __FlashStringHelper *Name, int16_t &Value, bool readonly) {
-  //check first map and manage if maximum number of transmittable variables has been exceeded
-  if (!CheckIdx()) {
-    return; //exit
-  }
-  //map the value
-  ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
-  //map the data type
-  ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_int16_t;
-  //map the name
-  if (CheckValidName(Name)) {
-      ArrayNames[indexglobal] = Name;
-  }
-  //read only
-  if (readonly) {
-    ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
+//registration table stored in flash (PROGMEM), see SERIALWATCHER_SLOT
+void cSerialWatcher::Map(const cSerialWatcherSlot *Table, uint16_t count) {
+  cSerialWatcherSlot slot;
+  for (uint16_t k = 0; k < count; k++) {
+    memcpy_P(&slot, &Table[k], sizeof(slot));
+    MapSlot((const __FlashStringHelper*) slot.name, slot.value, slot.features & SERIALWATCHER_FEATURES_MASK_DATATYPE, slot.codec, 
+            (slot.features & SERIALWATCHER_FEATURES_MASK_READONLY) == SERIALWATCHER_FEATURES_MASK_READONLY);
   }
-  //
-  indexglobal += 1;
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//uint16_t
-void cSerialWatcher::Map(const __FlashStringHelper *Name, uint16_t &Value, bool readonly) {
-  //check first map and manage if maximum number of transmittable variables has been exceeded
-  if (!CheckIdx()) {
-    return; //exit
-  }
-  //map the value
-  ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
-  //map the data type
-  ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_uint16_t;
-  //map the name
-  if (CheckValidName(Name)) {
-      ArrayNames[indexglobal] = Name;
-  }
-  //read only
-  if (readonly) {
-    ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
+//write a fixed text
+void cSerialWatcher::Text(const __FlashStringHelper *Value) {
+  this->Map(Value, F("")); //uses the flashstring map
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//add an empty space
+void cSerialWatcher::EmptySpace() {
+  this->Map(F(""), F("")); //uses the flashstring map
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//select the tx mode, the active stream is completed before switching
+void cSerialWatcher::TxMode(byte mode) {
+  _txmoderequest = mode;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//paged streams: only the slots page*size ... page*size+size-1 are sent (size 0 = whole table), applied at the next stream start
+void cSerialWatcher::TxPage(uint16_t size, uint16_t page) {
+  _pagesize = size;
+  _page = page;
+  #if SERIALWATCHER_TX_DELTA
+  _txframe = 0; //the first stream of a new page is a keyframe
+  #endif
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_SUBSCRIBE
+//subscription: the mapped slots first ... last are sent (or skipped) from the next stream start
+void cSerialWatcher::TxSubscribe(uint16_t first, uint16_t last, bool subscribed) {
+  for (uint32_t k = first; k <= last && k < SlotCount; k++) {
+    if (subscribed) {
+      ArraySubscribed[k >> 3] |= (byte)(1 << (k & 7)); //SET
+    }
+    else {
+      ArraySubscribed[k >> 3] &= (byte)~(1 << (k & 7)); //CLEAR
+    }
   }
-  //
-  indexglobal += 1;
+  #if SERIALWATCHER_TX_DELTA
+  _txframe = 0; //the slots subscribed again are sent in a keyframe
+  #endif
 }
+#endif
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-#if defined(ARDUINO_UNOR4_MINIMA) || defined(ARDUINO_UNOR4_WIFI)
-void cSerialWatcher::Map(const __FlashStringHelper *Name, int &Value, bool readonly) {
-  //check first map and manage if maximum number of transmittable variables has been exceeded
-  if (!CheckIdx()) {
-    return; //exit
+//delta mode deadband of the last mapped float variable, to be called right after its map
+void cSerialWatcher::Deadband(float band) {
+  #if SERIALWATCHER_TX_DELTA
+  //only at the first map, when the last mapped slot is known
+  if ((_mem & SERIALWATCHER_MEMO_FISTMAPDONE) == SERIALWATCHER_MEMO_FISTMAPDONE || 
+      (_mem & SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR) == SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR ||
+      SlotCount == 0 || _deadbands >= SERIALWATCHER_TX_DELTA_DEADBANDS) {
+    return;
   }
-  //map the value
-  ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
-  //map the data type
-  ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_int32_t;
-  //map the name
-  if (CheckValidName(Name)) {
-      ArrayNames[indexglobal] = Name;
+  if ((ArrayFeatures[SlotCount-1] & (SERIALWATCHER_FEATURES_MASK_DATATYPE | SERIALWATCHER_FEATURES_MASK_ARRAY)) != SERIALWATCHER_DATATYPE_float) {
+    return; //single float only
   }
-  //read only
-  if (readonly) {
-    ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
+  DeadbandSlots[_deadbands] = SlotCount-1;
+  DeadbandValues[_deadbands] = band;
+  _deadbands += 1;
+  #else
+  (void)band;
+  #endif
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_ALARM
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//raw value of a numeric variable (little-endian boards)
+static uint64_t AlarmRaw(const void *value, byte size) {
+  uint64_t raw = 0;
+  memcpy(&raw, value, size);
+  return raw;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//value of a numeric variable compared with the limit of the alarm
+static float AlarmValue(byte datatype, const void *value) {
+  switch (datatype) {
+    case SERIALWATCHER_DATATYPE_bool: return *(const bool*)value ? 1 : 0;
+    case SERIALWATCHER_DATATYPE_int8_t: return *(const int8_t*)value;
+    case SERIALWATCHER_DATATYPE_uint8_t: return *(const uint8_t*)value;
+    case SERIALWATCHER_DATATYPE_int16_t: return *(const int16_t*)value;
+    case SERIALWATCHER_DATATYPE_uint16_t: return *(const uint16_t*)value;
+    case SERIALWATCHER_DATATYPE_int32_t: return *(const int32_t*)value;
+    case SERIALWATCHER_DATATYPE_uint32_t: return *(const uint32_t*)value;
+    case SERIALWATCHER_DATATYPE_int64_t: return *(const int64_t*)value;
+    case SERIALWATCHER_DATATYPE_uint64_t: return *(const uint64_t*)value;
+    case SERIALWATCHER_DATATYPE_float: return *(const float*)value;
   }
-  //
-  indexglobal += 1;
+  return 0;
 }
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
 #endif
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//int32_t
-void cSerialWatcher::Map(const __FlashStringHelper *Name, int32_t &Value, bool readonly) {
-  //check first map and manage if maximum number of transmittable variables has been exceeded
-  if (!CheckIdx()) {
-    return; //exit
+//watch condition of the last mapped variable (bool, integer or float), to be called right after its map
+//the condition is checked at every Update(), an alarm raised at the first Update() is sent too
+void cSerialWatcher::Alarm(byte condition, float limit) {
+  AlarmWatch(condition, limit, (limit > 0 && limit < 4294967296.0f) ? (uint32_t)limit : 0);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcher::AlarmWatch(byte condition, float limit, uint32_t mask) {
+  #if SERIALWATCHER_TX_ALARM
+  //only at the first map, when the last mapped slot is known
+  if ((_mem & SERIALWATCHER_MEMO_FISTMAPDONE) == SERIALWATCHER_MEMO_FISTMAPDONE || 
+      (_mem & SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR) == SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR ||
+      SlotCount == 0 || _alarms >= SERIALWATCHER_TX_ALARM_MAX || condition > SERIALWATCHER_ALARM_CHANGE) {
+    return;
   }
-  //map the value
-  ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
-  //map the data type
-  ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_int32_t;
-  //map the name
-  if (CheckValidName(Name)) {
-      ArrayNames[indexglobal] = Name;
+  cSerialWatcherIndex i = SlotCount-1;
+  byte size = pgm_read_byte(&DataTypeSize[ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+  if (size == 0 || (ArrayFeatures[i] & (SERIALWATCHER_FEATURES_MASK_DATATYPE | SERIALWATCHER_FEATURES_MASK_ARRAY)) == SERIALWATCHER_DATATYPE_char || 
+      (ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_ARRAY) == SERIALWATCHER_FEATURES_MASK_ARRAY) {
+    return; //single number only (a char can be a separator)
   }
-  //read only
-  if (readonly) {
-    ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
+  AlarmSlots[_alarms] = i;
+  AlarmConditions[_alarms] = condition;
+  AlarmLimits[_alarms] = limit;
+  AlarmBits[_alarms] = 0;
+  if (condition == SERIALWATCHER_ALARM_MASK) {
+    AlarmBits[_alarms] = mask;
   }
-  //
-  indexglobal += 1;
+  if (condition == SERIALWATCHER_ALARM_CHANGE) {
+    uint64_t raw = AlarmRaw(ArrayValues[i], size);
+    AlarmBits[_alarms] = (uint32_t)raw ^ (uint32_t)(raw >> 32); //first value, not an alarm
+  }
+  _alarms += 1;
+  #else
+  (void)condition;
+  (void)limit;
+  (void)mask;
+  #endif
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//uint32_t
-void cSerialWatcher::Map(const __FlashStringHelper *Name, uint32_t &Value, bool readonly) { 
-  //check first map and manage if maximum number of transmittable variables has been exceeded
-  if (!CheckIdx()) {
-    return; //exit
+//binary stream encoding of the last mapped float variable, to be called right after its map
+//SERIALWATCHER_FLOAT_HALF: half precision, SERIALWATCHER_FLOAT_FIXED: int16_t, value = offset + integer * scale (scale != 0)
+void cSerialWatcher::FloatEncoding(byte encoding, float scale, float offset) {
+  #if SERIALWATCHER_TX_FLOATENC
+  //only at the first map, when the last mapped slot is known
+  if ((_mem & SERIALWATCHER_MEMO_FISTMAPDONE) == SERIALWATCHER_MEMO_FISTMAPDONE || 
+      (_mem & SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR) == SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR ||
+      SlotCount == 0 || _floatencs >= SERIALWATCHER_TX_FLOATENC_MAX) {
+    return;
   }
-  //map the value
-  ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
-  //map the data type
-  ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_uint32_t;
-  //map the name
-  if (CheckValidName(Name)) {
-      ArrayNames[indexglobal] = Name;
+  if ((ArrayFeatures[SlotCount-1] & (SERIALWATCHER_FEATURES_MASK_DATATYPE | SERIALWATCHER_FEATURES_MASK_ARRAY)) != SERIALWATCHER_DATATYPE_float) {
+    return; //single float only
   }
-  //read only
-  if (readonly) {
-    ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
+  if (encoding == SERIALWATCHER_FLOAT_HALF) {
+    FloatEncTypes[_floatencs] = SERIALWATCHER_DATATYPE_half;
   }
-  //
-  indexglobal += 1;
+  else if (encoding == SERIALWATCHER_FLOAT_FIXED && scale != 0) {
+    FloatEncTypes[_floatencs] = SERIALWATCHER_DATATYPE_fixed16;
+  }
+  else {
+    return; //raw
+  }
+  FloatEncSlots[_floatencs] = SlotCount-1;
+  FloatEncScales[_floatencs] = scale;
+  FloatEncOffsets[_floatencs] = offset;
+  _floatencs += 1;
+  #else
+  (void)encoding;
+  (void)scale;
+  (void)offset;
+  #endif
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//int64_t
-void cSerialWatcher::Map(const __FlashStringHelper *Name, int64_t &Value, bool readonly) { 
-  //check first map and manage if maximum number of transmittable variables has been exceeded
-  if (!CheckIdx()) {
-    return; //exit
+//refresh class of the last mapped variable, to be called right after its map
+//every = SERIALWATCHER_REFRESH_ONCHANGE, SERIALWATCHER_REFRESH_ALWAYS or 2, 4, 8 ... 128 streams (other values are rounded down to a power of two)
+void cSerialWatcher::Refresh(byte every) {
+  #if SERIALWATCHER_TX_REFRESH
+  //only at the first map, when the last mapped slot is known
+  if ((_mem & SERIALWATCHER_MEMO_FISTMAPDONE) == SERIALWATCHER_MEMO_FISTMAPDONE || 
+      (_mem & SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR) == SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR || SlotCount == 0) {
+    return;
   }
-  //map the value
-  ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
-  //map the data type
-  ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_int64_t;
-  //map the name
-  if (CheckValidName(Name)) {
-      ArrayNames[indexglobal] = Name;
+  byte shift = 0xFF; //on change only
+  if (every != SERIALWATCHER_REFRESH_ONCHANGE) {
+    shift = 0;
+    while ((every >> shift) > 1) {
+      shift++;
+    }
   }
-  //read only
-  if (readonly) {
-    ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
+  ArrayRefresh[SlotCount-1] = shift;
+  if (shift != 0) {
+    _mem = _mem | SERIALWATCHER_MEMO_TX_REFRESH; //SET
   }
-  //
-  indexglobal += 1;
+  #else
+  (void)every;
+  #endif
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//uint64_t
-void cSerialWatcher::Map(const __FlashStringHelper *Name, uint64_t &Value, bool readonly) { 
-  //check first map and manage if maximum number of transmittable variables has been exceeded
-  if (!CheckIdx()) {
-    return; //exit
-  }
-  //map the value
-  ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
-  //map the data type
-  ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_uint64_t;
-  //map the name
-  if (CheckValidName(Name)) {
-      ArrayNames[indexglobal] = Name;
+#if SERIALWATCHER_TX_NUMARRAYS
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//numeric array: the last mapped slot points to the first of length values (see the Map template)
+//with all the SERIALWATCHER_TX_NUMARRAYS_MAX arrays in use the slot keeps only the first value (the profiling has its own entry, see ProfileMap())
+void cSerialWatcher::MapArray(uint16_t length, byte max) {
+  //only at the first map, when the last mapped slot is known
+  if ((_mem & SERIALWATCHER_MEMO_FISTMAPDONE) == SERIALWATCHER_MEMO_FISTMAPDONE || 
+      (_mem & SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR) == SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR ||
+      SlotCount == 0 || _numarrays >= max) {
+    return;
   }
-  //read only
-  if (readonly) {
-    ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
-  }
-  //
-  indexglobal += 1;
+  NumArraySlots[_numarrays] = SlotCount-1;
+  NumArrayLengths[_numarrays] = length;
+  _numarrays += 1;
+  ArrayFeatures[SlotCount-1] = ArrayFeatures[SlotCount-1] | SERIALWATCHER_FEATURES_MASK_ARRAY; //SET
 }
-//#endif
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//float
-void cSerialWatcher::Map(const __FlashStringHelper *Name, float &Value, bool readonly) {
-  //check first map and manage if maximum number of transmittable variables has been exceeded
-  if (!CheckIdx()) {
-    return; //exit
-  }
-  //map the value
-  ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
-  //map the data type
-  ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_float;
-  //map the name
-  if (CheckValidName(Name)) {
-      ArrayNames[indexglobal] = Name;
-  }
-  //read only
-  if (readonly) {
-    ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
+//number of values of a numeric array (1 for the other slots)
+uint16_t cSerialWatcher::ArrayLength(cSerialWatcherIndex i) {
+  if ((ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_ARRAY) == SERIALWATCHER_FEATURES_MASK_ARRAY) {
+    for (byte k = 0; k < _numarrays; k++) {
+      if (NumArraySlots[k] == i) {
+        return NumArrayLengths[k];
+      }
+    }
   }
-  //
-  indexglobal += 1;
+  return 1;
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//char
-void cSerialWatcher::Map(const __FlashStringHelper *Name, char &Value, bool readonly) { 
-  //only once at every transmission cycle
-  if (TxIdx == 0) {
-    //check if maximum number of transmittable variables has been exceeded
-    if (indexglobal >=  SERIALWATCHER_TX_MAX_VALUES-1) {
-      _mem = _mem | SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR; //SET
-      return;
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcher::Update(){
+  //first map done
+  if ((_mem & SERIALWATCHER_MEMO_FISTMAPDONE) != SERIALWATCHER_MEMO_FISTMAPDONE) {
+    #if SERIALWATCHER_PROFILE
+    ProfileMap();
+    #endif
+    _mem = _mem | SERIALWATCHER_MEMO_FISTMAPDONE; //SET
+  }
+  else {
+    #if SERIALWATCHER_PROFILE
+    unsigned long start = micros();
+    #endif
+    #if SERIALWATCHER_RX_BATCH
+    if (_batchstate == SERIALWATCHER_RX_BATCH_COMMIT) { //batch received in the previous Update()
+      RxCommit();
     }
-    //first map done -> check for invalid value, update index and exit
-    if((_mem & SERIALWATCHER_MEMO_FISTMAPDONE) == SERIALWATCHER_MEMO_FISTMAPDONE) {
-      //check for valid value
-      if (IsCharValid(*(char*)ArrayValues[indexglobal])) {
-        ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] &~ SERIALWATCHER_FEATURES_MASK_INVALID_VALUE; //CLEAR
-      }
-      else
-      {
-        ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_INVALID_VALUE; //SET
-      }
-      //update index
-      indexglobal += 1;
-      //exit
-      return;
+    #endif
+    #if SERIALWATCHER_SCOPE
+    if (_scopedecimation != 0) {
+      ScopeSample();
     }
-    //first map
-    else {
-      //map the value
-      ArrayValues[indexglobal] = &Value; //to store the pointer in a variable & is still needed to get the address
-      //map the data type
-      ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_char;
-      //map the name
-      if (CheckValidName(Name)) {
-          ArrayNames[indexglobal] = Name;
-      }
-      //check for valid value
-      if (IsCharValid(*(char*)ArrayValues[indexglobal])) {
-        ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] &~ SERIALWATCHER_FEATURES_MASK_INVALID_VALUE; //CLEAR
-      }
-      else
-      {
-        ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_INVALID_VALUE; //SET
-      }
-      //read only
-      if (readonly) {
-        ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
-      }
-      //
-      indexglobal += 1;
+    #endif
+    #if SERIALWATCHER_TX_ALARM
+    if (_alarms != 0) {
+      AlarmCheck();
     }
+    #endif
+    Tx();
+    #if SERIALWATCHER_PROFILE
+    unsigned long txend = micros();
+    #endif
+    Rx();
+    #if SERIALWATCHER_PROFILE
+    Profile(start, txend);
+    #endif
+  }
+  //the variables can be mapped once (setup) or at every loop (old style)
+  //with the old style the FlashString maps update the value (because the pointed address in flash memory could change), 
+  //to achive that, the map cursor indexglobal is cleared after every transmission cycle (that happens at the stream start)
+  //the values that can contain a separator are checked when mapped and written from the pc (FlashString), or before each transmission (Char, Array of Char), see CheckValue()
+  if (TxState == SERIALWATCHER_TX_STATE_START) { //at every transmission cycle
+    indexglobal = 0;
   }
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//array of char - pointers to the first element of the array char
-void cSerialWatcher::Map(const __FlashStringHelper *Name, char *Value, bool readonly) { 
-  //only once at every transmission cycle
-  if (TxIdx == 0) {
-    //check if maximum number of transmittable variables has been exceeded
-    if (indexglobal >=  SERIALWATCHER_TX_MAX_VALUES-1) {
-      _mem = _mem | SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR; //SET
-      return;
-    }
-    //first map done -> check for invalid value, update index and exit
-    if((_mem & SERIALWATCHER_MEMO_FISTMAPDONE) == SERIALWATCHER_MEMO_FISTMAPDONE) {
-      //check for valid value
-      if (IsTextValid((char*)ArrayValues[indexglobal])) {
-        ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] &~ SERIALWATCHER_FEATURES_MASK_INVALID_VALUE; //CLEAR
-      }
-      else
-      {
-        ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_INVALID_VALUE; //SET
-      }
-      //update index
-      indexglobal += 1;
-      //exit
-      return;
-    }
-    //first map
-    else {
-      //map the value
-      ArrayValues[indexglobal] = Value;
-      //map the data type
-      ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_achar;
-      //map the name
-      if (CheckValidName(Name)) {
-          ArrayNames[indexglobal] = Name;
-      }
-      //check for valid value
-      if (IsTextValid((char*)ArrayValues[indexglobal])) {
-        ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] &~ SERIALWATCHER_FEATURES_MASK_INVALID_VALUE; //CLEAR
-      }
-      else
-      {
-        ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_INVALID_VALUE; //SET
-      }
-      //read only
-      if (readonly) {
-        ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_READONLY; // SET
-      }
-      //
-      indexglobal += 1;
-    }
+#if SERIALWATCHER_PROFILE
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//free ram between the heap and the stack (0 = not available on this board)
+static uint32_t FreeRam() {
+  #if defined(__AVR__)
+  extern int __heap_start, *__brkval;
+  char top;
+  return (uint32_t)(&top - (__brkval == 0 ? (char*)&__heap_start : (char*)__brkval));
+  #elif defined(ESP8266) || defined(ESP32)
+  return ESP.getFreeHeap();
+  #else
+  return 0;
+  #endif
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+static uint16_t Saturate16(unsigned long val) {
+  return (val > 0xFFFF) ? 0xFFFF : (uint16_t)val;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//the profiling values are ordinary read only slots, appended after the mapped variables at the first Update()
+//all or none: without room for all of them the table is flagged as exceeded (SERIALWATCHER_TX_CODE_EXCEEDED_MAX_TXVAR)
+void cSerialWatcher::ProfileMap() {
+  if (indexglobal + SERIALWATCHER_PROFILE_SLOTS >= SERIALWATCHER_TX_MAX_VALUES) {
+    _mem = _mem | SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR; //SET
+    return;
   }
+  Map(F("sw.tx_us"), _proftxus, true);
+  Map(F("sw.rx_us"), _profrxus, true);
+  Map(F("sw.max_us"), _profmaxus, true);
+  MapSlot(F("sw.loop"), _profloop, SERIALWATCHER_DATATYPE_uint16_t, &cSerialWatcherTraits<uint16_t>::codec, true);
+  MapArray(SERIALWATCHER_PROFILE_BUCKETS, SERIALWATCHER_NUMARRAYS_TABLE); //the histogram is there even with all the user arrays in use
+  Map(F("sw.tx_bytes"), _proftxbytes, true);
+  Map(F("sw.rx_bytes"), _profrxbytes, true);
+  Map(F("sw.fps"), _proffps, true);
+  Map(F("sw.rx_errors"), _proferrors, true);
+  Map(F("sw.rx_overflows"), _profoverflows, true);
+  Map(F("sw.free"), _proffree, true);
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//flashstring
-void cSerialWatcher::Map(const __FlashStringHelper *Name, const __FlashStringHelper *Value) {
-  //only once at every transmission cycle
-  if (TxIdx == 0) {
-    //check if maximum number of transmittable variables has been exceeded
-    if (indexglobal >=  SERIALWATCHER_TX_MAX_VALUES-1) {
-      _mem = _mem | SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR; //SET
-      return;
-    }
-    //map the data type
-    ArrayFeatures[indexglobal] = SERIALWATCHER_DATATYPE_flashstring;
-    //map the name
-    if (CheckValidName(Name)) {
-        ArrayNames[indexglobal] = Name;
+// - Profiling values of one Update() -
+// start = Update() start, txend = Tx() end, the time spent here is counted in the next Update()
+// the loop period is the time between two Update() starts, bucket k counts the periods below 128 << 2k microseconds
+//
+void cSerialWatcher::Profile(unsigned long start, unsigned long txend) {
+  unsigned long end = micros();
+  _proftxus = Saturate16(txend - start);
+  _profrxus = Saturate16(end - txend);
+  _proftxbytes += TxSent;
+  if (Saturate16(end - start) > _profmaxrun) {
+    _profmaxrun = Saturate16(end - start);
+  }
+  //loop period histogram
+  if (_proflast != 0) {
+    unsigned long period = start - _proflast;
+    byte k = 0;
+    while (k < SERIALWATCHER_PROFILE_BUCKETS-1 && period >= (128UL << (2 * k))) {
+      k++;
     }
-    //check for valid pointer (value)
-    if (Value != nullptr) {
-      //check for valid value
-      if (IsTextValid(Value)) {
-        ArrayValues[indexglobal] = (__FlashStringHelper*) Value;
-      }
-      else {
-        ArrayFeatures[indexglobal] = ArrayFeatures[indexglobal] | SERIALWATCHER_FEATURES_MASK_INVALID_VALUE;
+    if (_profloop[k] == 0xFFFF) {
+      for (byte n = 0; n < SERIALWATCHER_PROFILE_BUCKETS; n++) {
+        _profloop[n] >>= 1;
       }
     }
-    else {
-      ArrayValues[indexglobal] = (__FlashStringHelper*) F("");
-    }
-    //
-    indexglobal += 1;
+    _profloop[k] += 1;
+  }
+  _proflast = start;
+  //once a second
+  if (end - _profwindow >= 1000000UL) {
+    _profwindow = end;
+    _proffps = _profframes;
+    _profframes = 0;
+    _profmaxus = _profmaxrun;
+    _profmaxrun = 0;
+    _proffree = FreeRam();
   }
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//write a fixed text
-void cSerialWatcher::Text(const __FlashStringHelper *Value) {
-  this->Map(Value, F("")); //uses the flashstring map
-}
-//-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//add an empty space
-void cSerialWatcher::EmptySpace() {
-  this->Map(F(""), F("")); //uses the flashstring map
-}
+#endif
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-void cSerialWatcher::Update(){
-  //first map done
-  if ((_mem & SERIALWATCHER_MEMO_FISTMAPDONE) != SERIALWATCHER_MEMO_FISTMAPDONE) {
-    _mem = _mem | SERIALWATCHER_MEMO_FISTMAPDONE; //SET
+//check the values that can't be sent when they contain a separator (Char, Array of Char, FlashString)
+//the result is cached in the invalid value flag of the features
+void cSerialWatcher::CheckValue(cSerialWatcherIndex i) {
+  bool valid;
+  switch (ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE) {
+    case SERIALWATCHER_DATATYPE_char:
+      valid = IsCharValid(*(char*)ArrayValues[i]);
+      break;
+    case SERIALWATCHER_DATATYPE_achar:
+      valid = IsTextValid((char*)ArrayValues[i]);
+      break;
+    case SERIALWATCHER_DATATYPE_flashstring:
+      valid = IsTextValid((const __FlashStringHelper*)ArrayValues[i]);
+      break;
+    default:
+      return;
   }
-  else {
-    Tx();
-    Rx();
+  if (valid) {
+    ArrayFeatures[i] = ArrayFeatures[i] &~ SERIALWATCHER_FEATURES_MASK_INVALID_VALUE; //CLEAR
   }
-  //for some datatypes (Char, Array of Char, FlashString) is necessary to execute the map function periodically
-  //that's because when there is a change on the value, the following things should be done again
-  //- Char: check for invalid value
-  //- Array of Char: check for invalid value
-  //- FlashString: update the value (because the pointed address in flash memory could change), check for invalid value
-  //to achive that, indexglobal should be cleared after every transmission cycle (that happens when TxIdx == 0)
-  if (TxIdx == 0) { //at every transmission cycle
-    indexglobal = 0;
+  else {
+    ArrayFeatures[i] = ArrayFeatures[i] | SERIALWATCHER_FEATURES_MASK_INVALID_VALUE; //SET
   }
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -536,24 +839,26 @@ bool cSerialWatcher::IsCharValid(char in_char) { //true: value is valid | false:
   }
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-bool cSerialWatcher::IsTextValid(char *in_achar) { //true: value is valid | false: value is invalid
-  if ( not this->StringSearchSubString(in_achar, SERIALWATCHER_TX_FIELD_SEPARATOR) and
-       not this->StringSearchSubString(in_achar, SERIALWATCHER_TX_ELEMENT_SEPARATOR)) {
-    return true;
-  }
-  else {
-    return false;
+bool cSerialWatcher::IsTextValid(const char *in_achar) { //true: value is valid | false: value is invalid
+  //single pass, stops at the first separator
+  for (const char *p = in_achar; *p != '\0'; p++) {
+    if (!IsCharValid(*p)) {
+      return false;
+    }
   }
+  return true;
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
 bool cSerialWatcher::IsTextValid(const __FlashStringHelper *in_flash) { //true: text is valid | false: text is invalid
-  if ( not this->StringSearchSubString(in_flash, SERIALWATCHER_TX_FIELD_SEPARATOR) and 
-       not this->StringSearchSubString(in_flash, SERIALWATCHER_TX_ELEMENT_SEPARATOR)) { 
-    return true;
-  }
-  else {
-    return false;
+  //single pass reading the flash memory one char at a time (no copy in ram)
+  const char *p = (const char*) in_flash;
+  char c;
+  while ((c = pgm_read_byte(p++)) != '\0') {
+    if (!IsCharValid(c)) {
+      return false;
+    }
   }
+  return true;
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
 // - Transmit data to PC with start and end markers -
@@ -597,351 +902,1731 @@ bool cSerialWatcher::IsTextValid(const __FlashStringHelper *in_flash) { //true:
 //   ----
 //   @#e*        the stream end
 //
+// when SERIALWATCHER_TX_MODE_BINARY is active the same sequence is sent as binary records, see TxBinaryRecord()
+// when SERIALWATCHER_TX_MODE_DELTA is active the stream starts with <+ and only the values changed since their last transmission are sent,
+// one stream every SERIALWATCHER_TX_DELTA_KEYFRAME is a full keyframe that starts with <* as usual
+// when SERIALWATCHER_TX_MODE_SCHEMA is active names and features are sent only in a schema frame <#version; ... *>,
+// when the mode is selected, when the mapping changes or on request <h"0"0>, the following value frames <=version; ... *> (<~ for delta) carry slot and value only
+//
 void cSerialWatcher::Tx() {
-  byte i;
-  switch (TxIdx) {
+  unsigned long start = micros();
+  TxSent = 0;
+  while (true) {
+    //wait until the bytes encoded before have been sent, the serial write never blocks the loop
+    if (!TxFlush()) {
+      return;
+    }
+    TxStep();
+    //send as much as possible of what has just been encoded
+    TxFlush();
+    //without a budget one step for each update
+    if (_txbudgetus == 0 && _txbudgetbytes == 0) {
+      return;
+    }
+    //waiting for the next stream, or next stream ready (it starts at the next update, after the map of the variables)
+    if (TxState == SERIALWATCHER_TX_STATE_WAIT || TxState == SERIALWATCHER_TX_STATE_START) {
+      return;
+    }
+    //budget spent
+    if (_txbudgetus != 0 && (micros() - start) >= _txbudgetus) {
+      return;
+    }
+    if (_txbudgetbytes != 0 && TxSent >= _txbudgetbytes) {
+      return;
+    }
+  }
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - One step of the tx state machine -
+// TxState start -> page (only for a paged stream) -> elements (TxSlot ... TxSlotEnd-1) -> end -> wait for the next stream
+// the state is kept apart from the slot number, so the table is not limited by the state codes
+//
+void cSerialWatcher::TxStep() {
+  cSerialWatcherIndex i;
+  bool checked = false; //value already checked by TxChanged()
+  #if SERIALWATCHER_TX_ALARM
+  //the alarms are sent at the next element boundary of the stream in progress, ahead of the sweep but one at a time, so the sweep goes on between them,
+  //or right away between the streams (the next stream still waits for its period)
+  if (_alarmpending != 0 && !_alarmturn && (TxState == SERIALWATCHER_TX_STATE_PAGE || TxState == SERIALWATCHER_TX_STATE_END || 
+                                            TxState == SERIALWATCHER_TX_STATE_WAIT || (TxState == SERIALWATCHER_TX_STATE_ELEMENTS && TxPart == 0))) {
+    TxAlarm();
+    _alarmturn = true;
+    return;
+  }
+  _alarmturn = false;
+  #endif
+  switch (TxState) {
   //stream start
-  case 0:
+  case SERIALWATCHER_TX_STATE_START:
+    #if SERIALWATCHER_TX_DELTA
+    //delta stream or keyframe (a new tx mode always starts with a keyframe), with refresh classes the streams are delta streams also in the other modes
+    if (((_txmoderequest & SERIALWATCHER_TX_MODE_DELTA) == SERIALWATCHER_TX_MODE_DELTA || (_mem & SERIALWATCHER_MEMO_TX_REFRESH) == SERIALWATCHER_MEMO_TX_REFRESH) && 
+        _txmode == _txmoderequest && _txframe != 0) {
+      _mem = _mem | SERIALWATCHER_MEMO_TX_DELTA_STREAM; //SET
+    }
+    else {
+      _mem = _mem &~ SERIALWATCHER_MEMO_TX_DELTA_STREAM; //CLEAR
+      _txframe = 0;
+    }
+    _txframe = (_txframe + 1) % SERIALWATCHER_TX_DELTA_KEYFRAME;
+    #endif
+    #if SERIALWATCHER_TX_REFRESH
+    _txcount += 1;
+    #endif
+    #if SERIALWATCHER_TX_ALARM
+    _alarmheld = 0; //the held changes can be sent again
+    #endif
+    #if SERIALWATCHER_TX_SCHEMA
+    //schema session: a schema frame is sent when the session starts, whenever the mapping changes, when the pc asks for it
+    //and when the session switches between ascii and binary (the pc keeps one schema for each of them)
+    if ((_txmoderequest & SERIALWATCHER_TX_MODE_SCHEMA) == SERIALWATCHER_TX_MODE_SCHEMA && 
+        ((_txmode & SERIALWATCHER_TX_MODE_SCHEMA) != SERIALWATCHER_TX_MODE_SCHEMA || _schemasent != _schemaversion ||
+         ((_txmoderequest ^ _txmode) & SERIALWATCHER_TX_MODE_BINARY) != 0 ||
+         (_mem & SERIALWATCHER_MEMO_TX_SCHEMA_REQUEST) == SERIALWATCHER_MEMO_TX_SCHEMA_REQUEST)) {
+      _mem = _mem | SERIALWATCHER_MEMO_TX_SCHEMA_FRAME; //SET
+      _mem = _mem &~ (SERIALWATCHER_MEMO_TX_SCHEMA_REQUEST | SERIALWATCHER_MEMO_TX_DELTA_STREAM); //CLEAR
+      _schemasent = _schemaversion;
+      #if SERIALWATCHER_TX_DELTA
+      _txframe = 0; //the first value frame is a keyframe
+      #endif
+    }
+    else {
+      _mem = _mem &~ SERIALWATCHER_MEMO_TX_SCHEMA_FRAME; //CLEAR
+    }
+    #endif
+    _txmode = _txmoderequest; //a new tx mode is applied only at the stream start
+    //slots of the stream: the whole table or the page selected by the pc
+    TxSlot = 0;
+    TxSlotEnd = SlotCount;
+    if (_pagesize != 0) {
+      uint32_t first = (uint32_t)_page * _pagesize;
+      TxSlot = (first < SlotCount) ? first : SlotCount;
+      TxSlotEnd = (first + _pagesize < SlotCount) ? first + _pagesize : SlotCount;
+    }
     _TxStartMillis = millis();
-    _serial->print(F(SERIALWATCHER_TX_CODE_STREAM_START));
-    TxIdx += 1;
+    TxPart = 0;
+    #if SERIALWATCHER_TX_SNAPSHOT
+    TxSnapshot();
+    #endif
+    #if SERIALWATCHER_TX_BINARY
+    if ((_txmode & SERIALWATCHER_TX_MODE_BINARY) == SERIALWATCHER_TX_MODE_BINARY) {
+      TxBuffer[3] = ((_mem & SERIALWATCHER_MEMO_TX_DELTA_STREAM) == SERIALWATCHER_MEMO_TX_DELTA_STREAM) ? SERIALWATCHER_TX_BIN_FLAG_DELTA : 0;
+      if (sizeof(cSerialWatcherIndex) > 1) {
+        TxBuffer[3] |= SERIALWATCHER_TX_BIN_FLAG_WIDE; //2 bytes slot numbers
+      }
+      #if SERIALWATCHER_TX_COMPACT
+      if ((_txmode & SERIALWATCHER_TX_MODE_COMPACT) == SERIALWATCHER_TX_MODE_COMPACT) {
+        TxBuffer[3] |= SERIALWATCHER_TX_BIN_FLAG_COMPACT;
+      }
+      #endif
+      #if SERIALWATCHER_TX_SCHEMA
+      if ((_txmode & SERIALWATCHER_TX_MODE_SCHEMA) == SERIALWATCHER_TX_MODE_SCHEMA) {
+        TxBuffer[3] |= ((_mem & SERIALWATCHER_MEMO_TX_SCHEMA_FRAME) == SERIALWATCHER_MEMO_TX_SCHEMA_FRAME) ? SERIALWATCHER_TX_BIN_FLAG_SCHEMA : SERIALWATCHER_TX_BIN_FLAG_VALUES;
+        TxBuffer[4] = _schemasent;
+        TxBinaryRecord(SERIALWATCHER_TX_BIN_RECORD_STREAM_START, 2);
+        TxState = SERIALWATCHER_TX_STATE_PAGE;
+        break;
+      }
+      #endif
+      TxBinaryRecord(SERIALWATCHER_TX_BIN_RECORD_STREAM_START, 1);
+      TxState = SERIALWATCHER_TX_STATE_PAGE;
+      break;
+    }
+    #endif
+    #if SERIALWATCHER_TX_SCHEMA
+    if ((_txmode & SERIALWATCHER_TX_MODE_SCHEMA) == SERIALWATCHER_TX_MODE_SCHEMA) {
+      if ((_mem & SERIALWATCHER_MEMO_TX_SCHEMA_FRAME) == SERIALWATCHER_MEMO_TX_SCHEMA_FRAME) {
+        TxPut(F(SERIALWATCHER_TX_CODE_SCHEMA_START));
+      }
+      else if ((_mem & SERIALWATCHER_MEMO_TX_DELTA_STREAM) == SERIALWATCHER_MEMO_TX_DELTA_STREAM) {
+        TxPut(F(SERIALWATCHER_TX_CODE_VALUES_START_DELTA));
+      }
+      else {
+        TxPut(F(SERIALWATCHER_TX_CODE_VALUES_START));
+      }
+      TxLen += FormatUnsigned((char*)&TxBuffer[TxLen], (uint32_t)_schemasent);
+      TxPut(*SERIALWATCHER_TX_ELEMENT_SEPARATOR);
+      TxState = SERIALWATCHER_TX_STATE_PAGE;
+      break;
+    }
+    #endif
+    if ((_mem & SERIALWATCHER_MEMO_TX_DELTA_STREAM) == SERIALWATCHER_MEMO_TX_DELTA_STREAM) {
+      TxPut(F(SERIALWATCHER_TX_CODE_STREAM_START_DELTA));
+    }
+    else {
+      TxPut(F(SERIALWATCHER_TX_CODE_STREAM_START));
+    }
+    TxState = SERIALWATCHER_TX_STATE_PAGE;
     break;
-  //steam data
-  case 1 ... 253:
-    i=TxIdx-1;
-    if (i >= indexglobal) {
-      TxIdx = 254;
+  //page of the table in the stream (paged streams only)
+  case SERIALWATCHER_TX_STATE_PAGE:
+    #if SERIALWATCHER_RX_BATCH
+    //acknowledge of the last batch, before the page (same state, the page follows in the next step)
+    if (_batchstate == SERIALWATCHER_RX_BATCH_ACK) {
+      _batchstate = SERIALWATCHER_RX_BATCH_IDLE;
+      #if SERIALWATCHER_TX_BINARY
+      if ((_txmode & SERIALWATCHER_TX_MODE_BINARY) == SERIALWATCHER_TX_MODE_BINARY) {
+        TxBuffer[3] = _batchseq;
+        TxBuffer[4] = _batchresult;
+        TxBuffer[5] = _batchcount;
+        TxBinaryRecord(SERIALWATCHER_TX_BIN_RECORD_ACK, 3);
+        break;
+      }
+      #endif
+      TxPut(F(SERIALWATCHER_TX_CODE_ACK));
+      TxLen += FormatUnsigned((char*)&TxBuffer[TxLen], (uint32_t)_batchseq);
+      TxPut(*SERIALWATCHER_TX_FIELD_SEPARATOR);
+      TxLen += FormatUnsigned((char*)&TxBuffer[TxLen], (uint32_t)_batchresult);
+      TxPut(*SERIALWATCHER_TX_FIELD_SEPARATOR);
+      TxLen += FormatUnsigned((char*)&TxBuffer[TxLen], (uint32_t)_batchcount);
+      TxPut(*SERIALWATCHER_TX_ELEMENT_SEPARATOR);
       break;
     }
-    //number sequence
-    _serial->print(i);
-    _serial->print(F(SERIALWATCHER_TX_FIELD_SEPARATOR));
-    //name
-    if ((ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_INVALID_NAME) != SERIALWATCHER_FEATURES_MASK_INVALID_NAME) { //!InvalidName
-      _serial->print(ArrayNames[i]);
-    }
-    _serial->print(F(SERIALWATCHER_TX_FIELD_SEPARATOR));
-    //value
-    if ((ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_INVALID_VALUE) != SERIALWATCHER_FEATURES_MASK_INVALID_VALUE) { //!InvalidValue
-      switch (ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE) {
-        case SERIALWATCHER_DATATYPE_bool:
-          _serial->print(*(bool*)ArrayValues[i]); //value - the first * gets the value at the pointed address
-          break;
-        case SERIALWATCHER_DATATYPE_int8_t:
-          _serial->print(*(int8_t*)ArrayValues[i]); //value - the first * gets the value at the pointed address
-          break;       
-        case SERIALWATCHER_DATATYPE_uint8_t:
-          _serial->print(*(uint8_t*)ArrayValues[i]); //value - the first * gets the value at the pointed address
-          break;
-        case SERIALWATCHER_DATATYPE_int16_t:
-          _serial->print(*(int16_t*)ArrayValues[i]); //value - the first * gets the value at the pointed address
-          break;
-        case SERIALWATCHER_DATATYPE_uint16_t:
-          _serial->print(*(uint16_t*)ArrayValues[i]); //value - the first * gets the value at the pointed address
-          break;
-        case SERIALWATCHER_DATATYPE_int32_t:
-          _serial->print(*(int32_t*)ArrayValues[i]); //value - the first * gets the value at the pointed address
-          break;
-        case SERIALWATCHER_DATATYPE_uint32_t:
-          _serial->print(*(uint32_t*)ArrayValues[i]); //value - the first * gets the value at the pointed address
-          break;
-        case SERIALWATCHER_DATATYPE_int64_t:
-          #if defined(ARDUINO_AVR_UNO) || defined(ARDUINO_AVR_MEGA2560)
-			this->print_long_long(*_serial, *(int64_t*)ArrayValues[i]);
-          #else
-            _serial->print(*(int64_t*)ArrayValues[i]); //value - the first * gets the value at the pointed address
-          #endif
-          break;
-        case SERIALWATCHER_DATATYPE_uint64_t:
-          #if defined(ARDUINO_AVR_UNO) || defined(ARDUINO_AVR_MEGA2560)
-			this->print_unsigned_long_long(*_serial, *(uint64_t*)ArrayValues[i]);
-          #else
-            _serial->print(*(uint64_t*)ArrayValues[i]); //value - the first * gets the value at the pointed address
-          #endif
-          break;
-        case SERIALWATCHER_DATATYPE_float:
-          _serial->print(*(float*)ArrayValues[i]); //value - the first * gets the value at the pointed address
-          break;
-        case SERIALWATCHER_DATATYPE_char:
-          _serial->print(*(char*)ArrayValues[i]); //value - the first * gets the value at the pointed address
-          break;
-        case SERIALWATCHER_DATATYPE_achar:
-          _serial->print((char*)ArrayValues[i]); //value
-          break;
-        case SERIALWATCHER_DATATYPE_flashstring:
-          _serial->print((const __FlashStringHelper*)ArrayValues[i]); //value
-          break;
+    #endif
+    TxState = SERIALWATCHER_TX_STATE_ELEMENTS;
+    if (_pagesize != 0) {
+      uint16_t pages = (SlotCount + _pagesize - 1) / _pagesize;
+      #if SERIALWATCHER_TX_BINARY
+      if ((_txmode & SERIALWATCHER_TX_MODE_BINARY) == SERIALWATCHER_TX_MODE_BINARY) {
+        TxBuffer[3] = (byte)_page;
+        TxBuffer[4] = (byte)(_page >> 8);
+        TxBuffer[5] = (byte)pages;
+        TxBuffer[6] = (byte)(pages >> 8);
+        TxBinaryRecord(SERIALWATCHER_TX_BIN_RECORD_PAGE, 4);
+        break;
+      }
+      #endif
+      TxPut(F(SERIALWATCHER_TX_CODE_PAGE));
+      TxLen += FormatUnsigned((char*)&TxBuffer[TxLen], (uint32_t)_page);
+      TxPut(*SERIALWATCHER_TX_FIELD_SEPARATOR);
+      TxLen += FormatUnsigned((char*)&TxBuffer[TxLen], (uint32_t)pages);
+      TxPut(*SERIALWATCHER_TX_ELEMENT_SEPARATOR);
+      break;
+    }
+    //fall through - whole table: the first element is sent in this step
+  case SERIALWATCHER_TX_STATE_ELEMENTS: //steam data
+    i = TxSlot;
+    #if SERIALWATCHER_TX_SUBSCRIBE
+    //skip the slots the pc doesn't display (a schema frame has all the names)
+    if (TxPart == 0 && (_mem & SERIALWATCHER_MEMO_TX_SCHEMA_FRAME) != SERIALWATCHER_MEMO_TX_SCHEMA_FRAME) {
+      i = TxSubscribed(i);
+      TxSlot = i;
+    }
+    #endif
+    #if SERIALWATCHER_TX_DELTA
+    //skip the unchanged values and the slots not due in this stream (in a keyframe all the values are sent and the shadow copy is refreshed)
+    if (((_txmode & SERIALWATCHER_TX_MODE_DELTA) == SERIALWATCHER_TX_MODE_DELTA || (_mem & SERIALWATCHER_MEMO_TX_REFRESH) == SERIALWATCHER_MEMO_TX_REFRESH) && 
+        TxPart == 0 && (_mem & SERIALWATCHER_MEMO_TX_SCHEMA_FRAME) != SERIALWATCHER_MEMO_TX_SCHEMA_FRAME) { //a schema frame has no values
+      while (i < TxSlotEnd && !TxDue(i, (_mem & SERIALWATCHER_MEMO_TX_DELTA_STREAM) != SERIALWATCHER_MEMO_TX_DELTA_STREAM)) {
+        i++;
+        #if SERIALWATCHER_TX_SUBSCRIBE
+        i = TxSubscribed(i);
+        #endif
+      }
+      TxSlot = i;
+      checked = (_txmode & SERIALWATCHER_TX_MODE_DELTA) == SERIALWATCHER_TX_MODE_DELTA; //TxChanged() called
+    }
+    #endif
+    if (i >= TxSlotEnd) {
+      TxState = SERIALWATCHER_TX_STATE_END;
+      break;
+    }
+    //the chars and the arrays of chars can change at any time, the flashstrings are checked when mapped
+    if (TxPart == 0 && !checked && (ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE) != SERIALWATCHER_DATATYPE_flashstring) {
+      CheckValue(i);
+    }
+    #if SERIALWATCHER_TX_BINARY
+    if ((_txmode & SERIALWATCHER_TX_MODE_BINARY) == SERIALWATCHER_TX_MODE_BINARY) {
+      byte type = SERIALWATCHER_TX_BIN_RECORD_ELEMENT;
+      #if SERIALWATCHER_TX_SCHEMA
+      if ((_txmode & SERIALWATCHER_TX_MODE_SCHEMA) == SERIALWATCHER_TX_MODE_SCHEMA) {
+        type = ((_mem & SERIALWATCHER_MEMO_TX_SCHEMA_FRAME) == SERIALWATCHER_MEMO_TX_SCHEMA_FRAME) ? SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT : SERIALWATCHER_TX_BIN_RECORD_VALUE;
+      }
+      #endif
+      #if SERIALWATCHER_TX_NUMARRAYS
+      //numeric array: element record without value (not in the value frames), then the records with the values
+      if ((ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_ARRAY) == SERIALWATCHER_FEATURES_MASK_ARRAY && type != SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT) {
+        if (TxPart == 0) {
+          TxPart = 5;
+          TxPartPos = 0;
+          if (type == SERIALWATCHER_TX_BIN_RECORD_ELEMENT) {
+            TxBinaryRecord(type, TxBinaryElement(i, type, &TxBuffer[3], SERIALWATCHER_TX_ARRAY_LENGTH - 5));
+            break;
+          }
+        }
+        if (TxBinaryArray(i)) {
+          TxPart = 0;
+          TxSlot += 1;
+        }
+        break;
       }
+      #endif
+      TxBinaryRecord(type, TxBinaryElement(i, type, &TxBuffer[3], SERIALWATCHER_TX_ARRAY_LENGTH - 5));
+      TxSlot += 1;
+      break;
+    }
+    #endif
+    //the element is encoded in TxBuffer, long names and texts are split over more updates
+    if (TxAsciiElement(i)) {
+      TxPart = 0;
+      TxSlot += 1;
     }
-    _serial->print(F(SERIALWATCHER_TX_FIELD_SEPARATOR));
-    //features (includes datatype)
-    _serial->print(ArrayFeatures[i]);
-    _serial->print(F(SERIALWATCHER_TX_ELEMENT_SEPARATOR));
-    TxIdx += 1;
     break;
   //check if maximum number of transmittable variables has been exceeded
-  case 254:
+  case SERIALWATCHER_TX_STATE_END:
+    #if SERIALWATCHER_PROFILE
+    _profframes += 1;
+    #endif
+    #if SERIALWATCHER_TX_BINARY
+    if ((_txmode & SERIALWATCHER_TX_MODE_BINARY) == SERIALWATCHER_TX_MODE_BINARY) {
+      TxBuffer[3] = ((_mem & SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR) == SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR) ? SERIALWATCHER_TX_BIN_FLAG_EXCEEDED_MAX_TXVAR : 0;
+      TxBinaryRecord(SERIALWATCHER_TX_BIN_RECORD_STREAM_END, 1);
+      TxState = SERIALWATCHER_TX_STATE_WAIT;
+      break;
+    }
+    #endif
     if ((_mem & SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR) == SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR)
     {
-      _serial->print(F(SERIALWATCHER_TX_CODE_EXCEEDED_MAX_TXVAR)); 
-      _serial->print(F(SERIALWATCHER_TX_ELEMENT_SEPARATOR));
+      TxPut(F(SERIALWATCHER_TX_CODE_EXCEEDED_MAX_TXVAR)); 
+      TxPut(F(SERIALWATCHER_TX_ELEMENT_SEPARATOR));
     } 
-    _serial->print(F(SERIALWATCHER_TX_CODE_STREAM_END));
-    TxIdx = 255;
+    TxPut(F(SERIALWATCHER_TX_CODE_STREAM_END));
+    TxState = SERIALWATCHER_TX_STATE_WAIT;
     break;
   //minimum time between successive transmission to allow pc-app decode data
-  case 255:
-    if ((millis()-_TxStartMillis) > 25) {
-      TxIdx = 0;
+  //the next stream starts only when the previous one has left the serial port, so the stream rate follows the link capacity
+  case SERIALWATCHER_TX_STATE_WAIT:
+    #if SERIALWATCHER_SCOPE
+    //the scope samples are sent between the streams, up to one ring buffer for each stream so the table keeps its rate
+    if (_scopecount != 0 && _scopeburst < _scopecapacity && (_txmode & SERIALWATCHER_TX_MODE_BINARY) == SERIALWATCHER_TX_MODE_BINARY) {
+      TxScopeBurst();
+      break;
+    }
+    #endif
+    if ((millis()-_TxStartMillis) > SERIALWATCHER_TX_STREAM_PERIOD && TxDrained()) {
+      TxState = SERIALWATCHER_TX_STATE_START;
+      #if SERIALWATCHER_SCOPE
+      _scopeburst = 0;
+      #endif
     }
     break;
   //
   default:
-    TxIdx = 0;
+    TxState = SERIALWATCHER_TX_STATE_START;
     break;
   }
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-// - Receive data from PC with start and end markers combined with parsing -
-// based on snipped code from https://forum.arduino.cc/index.php?topic=396450
-// this function expects to receive data from pc in this format <DataType:ArrayPlace:Value>, where
-// <          is the stream start
-// DataType   is the data type
-// ArrayPlace is the array place
-// Value      is the value
-// >          is the stream end
-// for example <b:12:0.0> is splitted as:   b DataType | 12 ArrayPlace | 0     Value
-// for example <i:12:37.0> is splitted as:  i DataType | 12 ArrayPlace | 37    Value
-// for example <f:12:86.42> is splitted as: f DataType | 12 ArrayPlace | 86.42 Value
-// for example <s:12:text> is splitted as:  s DataType | 12 ArrayPlace | text  Value
+//tx time budget of each update in microseconds and/or bytes, as many elements as fit are sent (0, 0 = one element for each update)
+void cSerialWatcher::TxBudget(unsigned int us, unsigned int bytes) {
+  _txbudgetus = us;
+  _txbudgetbytes = bytes;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - true when the serial tx buffer is empty -
+// the size of the serial tx buffer is learned from the biggest availableForWrite() ever seen
 //
-void cSerialWatcher::Rx() {
-  if (_serial->available() > 0) { //only when receive data
-    char c = _serial->read(); //read the incoming char
-    int rxidx = this->StringPositionSingleChar(RxBuffer, SERIALWATCHER_RX_BUFFER_END_IDX); //read end of data buffer idx
-    if (rxidx == -1) { //rx not in progress
-        if (c == SERIALWATCHER_RX_CODE_STREAM_START) {
-          RxBuffer[0] = SERIALWATCHER_RX_BUFFER_END_IDX; //put at the first slot Rx_Buffer End index
-        }
+bool cSerialWatcher::TxDrained() {
+  if ((_mem & SERIALWATCHER_MEMO_TX_AFW) != SERIALWATCHER_MEMO_TX_AFW) {
+    return true; //availableForWrite() not implemented, the writes are blocking
+  }
+  int room = _serial->availableForWrite();
+  if (room > _txroom) {
+    _txroom = room;
+  }
+  return room >= _txroom;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Send the pending bytes of TxBuffer with a single write -
+// only the bytes that fit in the serial tx buffer (availableForWrite) are written, the rest waits for the next update
+// streams that do not implement availableForWrite() (it always returns 0) are written as a whole like Serial.print() does
+// returns true when TxBuffer is empty
+//
+bool cSerialWatcher::TxFlush() {
+  byte n = TxLen - TxPos;
+  if (n > 0) {
+    int room = _serial->availableForWrite();
+    if (room > 0) {
+      _mem = _mem | SERIALWATCHER_MEMO_TX_AFW; //SET
+      if (room > _txroom) {
+        _txroom = room;
+      }
     }
-    else { //rx in progress
-      if (c != SERIALWATCHER_RX_CODE_STREAM_END) {
-        if (rxidx < (SERIALWATCHER_RX_ARRAY_LENGTH -1)) { 
-          RxBuffer[rxidx] = c; //collect character
-          RxBuffer[rxidx+1] = SERIALWATCHER_RX_BUFFER_END_IDX; //shift Rx_Buffer End index
+    else if ((_mem & SERIALWATCHER_MEMO_TX_AFW) != SERIALWATCHER_MEMO_TX_AFW) {
+      room = n; //availableForWrite() not implemented -> blocking write
+    }
+    if (room < n) {
+      n = room;
+    }
+    if (n > 0) {
+      _serial->write(&TxBuffer[TxPos], n);
+      TxPos += n;
+      TxSent += n;
+    }
+  }
+  if (TxPos >= TxLen) {
+    TxPos = 0;
+    TxLen = 0;
+    return true;
+  }
+  return false;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcher::TxPut(char c) {
+  TxBuffer[TxLen] = c;
+  TxLen += 1;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcher::TxPut(const __FlashStringHelper *s) {
+  TxLen += StringCopy(&TxBuffer[TxLen], s, SERIALWATCHER_TX_ARRAY_LENGTH - TxLen);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Encode one ascii element in TxBuffer -
+// number sequence " name " value " features ;
+// schema session: number sequence " name " features ; in the schema frames, number sequence " value ; in the value frames (number sequence ; = invalid value)
+// the element is built in parts (TxPart), texts longer than the free room of TxBuffer continue from TxPartPos at the next call
+// returns true when the element has been completely encoded
+//
+bool cSerialWatcher::TxAsciiElement(cSerialWatcherIndex i) {
+  byte room;
+  #if SERIALWATCHER_TX_SCHEMA
+  bool schemaframe = (_mem & SERIALWATCHER_MEMO_TX_SCHEMA_FRAME) == SERIALWATCHER_MEMO_TX_SCHEMA_FRAME;
+  bool valueframe = !schemaframe && (_txmode & SERIALWATCHER_TX_MODE_SCHEMA) == SERIALWATCHER_TX_MODE_SCHEMA;
+  #else
+  const bool schemaframe = false;
+  const bool valueframe = false;
+  #endif
+  while (true) {
+    room = SERIALWATCHER_TX_ARRAY_LENGTH - TxLen;
+    switch (TxPart) {
+      //number sequence
+      case 0:
+        if (room < 4) {
+          return false;
         }
-        else {
-          //error: rx buffer lenght overflow
-          #if SERIALWATCHER_RX_ADV_DIAGNOSTICS //to enable advanced diagnostics edit #define at the beginning of this file
-            _serial->println();
-            _serial->print(F("Error! Rx Buffer Lenght Overflow"));
-            delay(5000);
+        TxLen += FormatUnsigned((char*)&TxBuffer[TxLen], (uint32_t)i);
+        TxPartPos = 0;
+        if (valueframe) {
+          TxPart = 2; //no name
+          break;
+        }
+        TxPut(*SERIALWATCHER_TX_FIELD_SEPARATOR);
+        TxPart = 1;
+        break;
+      //name
+      case 1:
+        if ((ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_INVALID_NAME) != SERIALWATCHER_FEATURES_MASK_INVALID_NAME) { //!InvalidName
+          const char *name = (const char*)ArrayNames[i] + TxPartPos;
+          byte n = StringCopy(&TxBuffer[TxLen], (const __FlashStringHelper*)name, room);
+          TxLen += n;
+          TxPartPos += n;
+          if (pgm_read_byte(name + n) != '\0') {
+            return false; //continue at the next call
+          }
+        }
+        TxPart = schemaframe ? 4 : 2; //no value in the schema frames
+        break;
+      //value
+      case 2:
+        if (room < 22) { //separator + longest number
+          return false;
+        }
+        TxPart = 4;
+        TxPartPos = 0;
+        if (!valueframe || (ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_INVALID_VALUE) != SERIALWATCHER_FEATURES_MASK_INVALID_VALUE) {
+          TxPut(*SERIALWATCHER_TX_FIELD_SEPARATOR);
+        }
+        if ((ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_INVALID_VALUE) != SERIALWATCHER_FEATURES_MASK_INVALID_VALUE) { //!InvalidValue
+          char *dst = (char*)&TxBuffer[TxLen];
+          #if SERIALWATCHER_TX_NUMARRAYS
+          if ((ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_ARRAY) == SERIALWATCHER_FEATURES_MASK_ARRAY) {
+            TxPart = 5; //array values
+          }
+          else
           #endif
-          //: clear data buffer for the next rx
-          RxBuffer[0] = '\0';
-          return;
+          if (ArrayCodecs[i]->Format != NULL) {
+            TxLen += ArrayCodecs[i]->Format(dst, TxValue(i)); //value
+          }
+          else {
+            TxPart = 3; //text
+          }
         }
-      } 
-      else { //stream end
-        //terminate the string
-        RxBuffer[rxidx] = '\0';
-        //: diagnostics
-        #if SERIALWATCHER_RX_ADV_DIAGNOSTICS //to enable advanced diagnostics edit #define at the beginning of this file
-          _serial->println();
-          _serial->println();
-          _serial->print(F("RxBuffer "));
-          _serial->print(RxBuffer);
-        #endif
-        //: Parse Data: split the data into its parts using strtok()
-        // strtok(char *string, const char *delim): breaks the string into a series of substrings. It returns a pointer to the beginning of each substring. If delimiter is not found returns a null pointer
-        // strtok(NULL,..) continues where the previous call left off
-        // strtok() modifies the initial string to be parsed, the string is subsequently unsafe and cannot be used in its original form
-        char qu[2];
-        qu[0] = SERIALWATCHER_RX_FIELD_SEPARATOR;
-        qu[1] = '\0';
-        // DataType - get the first part
-        char DataType = strtok(RxBuffer, qu)[0]; //strtok(): breaks the string into a series of substrings; it returns a pointer to the beginning of each substring. If delimiter is not found returns a null pointer
-        // ArrayPlace - get the second part
-        byte ArrayPlace = atoi(strtok(NULL, qu)); //strtok(NULL,..) continues where the previous call left off
-        // Value - get the third part
-        char *Value = strtok(NULL, qu); //strtok(NULL,..) continues where the previous call left off
-        //: diagnostics
-        #if SERIALWATCHER_RX_ADV_DIAGNOSTICS //to enable advanced diagnostics edit #define at the beginning of this file
-          _serial->println();
-          _serial->print(F("DataType "));
-          _serial->println(DataType);
-          _serial->print(F("ArrayPlace "));
-          _serial->println(ArrayPlace);
-          _serial->print(F("Value "));
-          _serial->println(Value);
-          _serial->println();
-        #endif
-        if (Value != NULL) {
-          //: write variables ----> put data inside variables using pointers
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_bool) {
-              *(bool*)ArrayValues[ArrayPlace] = (Value[0] == '1');
-            }
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_int8_t) {
-              *(int8_t*)ArrayValues[ArrayPlace] = atoi(Value);
-            }
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_uint8_t) {
-              *(uint8_t*)ArrayValues[ArrayPlace] = atoi(Value);
-            }
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_int16_t) {
-              *(int16_t*)ArrayValues[ArrayPlace] = atoi(Value);
-            }
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_uint16_t) {
-              *(uint16_t*)ArrayValues[ArrayPlace] = atoi(Value);
-            }
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_int32_t) {
-              *(int32_t*)ArrayValues[ArrayPlace] = atol(Value);
-            }
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_uint32_t) {
-              *(uint32_t*)ArrayValues[ArrayPlace] = atol(Value);
-            }
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_int64_t) {
-			#if defined(ARDUINO_AVR_UNO) || defined(ARDUINO_AVR_MEGA2560)
-				*(int64_t*)ArrayValues[ArrayPlace] = this->atoll(Value);
-			#else
-				*(int64_t*)ArrayValues[ArrayPlace] = strtoll(Value, NULL, 10);
-			#endif
-            }
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_uint64_t) {
-			#if defined(ARDUINO_AVR_UNO) || defined(ARDUINO_AVR_MEGA2560)
-				*(uint64_t*)ArrayValues[ArrayPlace] = this->atoull(Value);
-			#else
-				*(uint64_t*)ArrayValues[ArrayPlace] = strtoull(Value, NULL, 10);
-			#endif
-            }
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_float) {
-              *(float*)ArrayValues[ArrayPlace] = atof(Value);
-            }
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_char) {
-              *(char*)ArrayValues[ArrayPlace] = Value[0];
-            }
-            if (DataType == SERIALWATCHER_RX_CODE_STREAM_achar) {
-              strcpy((char*)ArrayValues[ArrayPlace], Value); //the destination string should be large enough to receive the copy!
-            }
+        break;
+      //text value
+      case 3:
+        if ((ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE) == SERIALWATCHER_DATATYPE_achar) {
+          const char *text = (const char*)ArrayValues[i] + TxPartPos;
+          byte n = StringCopy(&TxBuffer[TxLen], text, room);
+          TxLen += n;
+          TxPartPos += n;
+          if (text[n] != '\0') {
+            return false; //continue at the next call
+          }
         }
         else {
-          #if SERIALWATCHER_RX_ADV_DIAGNOSTICS //to enable advanced diagnostics edit #define at the beginning of this file
-            _serial->println();
-            _serial->print(F("Error! Value is NULL pointer"));
-          #endif
+          const char *text = (const char*)ArrayValues[i] + TxPartPos;
+          byte n = StringCopy(&TxBuffer[TxLen], (const __FlashStringHelper*)text, room);
+          TxLen += n;
+          TxPartPos += n;
+          if (pgm_read_byte(text + n) != '\0') {
+            return false; //continue at the next call
+          }
         }
-        #if SERIALWATCHER_RX_ADV_DIAGNOSTICS //to enable advanced diagnostics edit #define at the beginning of this file
-          delay(5000); //add a big delay to let the user evaluate the printed out results 
-        #endif
-        //: clear data buffer for the next rx
-        RxBuffer[0] = '\0';
+        TxPart = 4;
+        break;
+      //features (includes datatype)
+      case 4:
+        if (room < 5) {
+          return false;
+        }
+        if (valueframe) {
+          TxPut(*SERIALWATCHER_TX_ELEMENT_SEPARATOR); //no features
+          return true;
+        }
+        TxPut(*SERIALWATCHER_TX_FIELD_SEPARATOR);
+        TxLen += FormatUnsigned((char*)&TxBuffer[TxLen], (uint32_t)ArrayFeatures[i]);
+        TxPut(*SERIALWATCHER_TX_ELEMENT_SEPARATOR);
+        return true;
+      #if SERIALWATCHER_TX_NUMARRAYS
+      //numeric array values, comma separated, long arrays are split over more updates
+      case 5: {
+        uint16_t length = ArrayLength(i);
+        byte size = pgm_read_byte(&DataTypeSize[ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+        while (TxPartPos < length) {
+          if (SERIALWATCHER_TX_ARRAY_LENGTH - TxLen < 22) { //separator + longest number
+            return false; //continue at the next call
+          }
+          if (TxPartPos != 0) {
+            TxPut(*SERIALWATCHER_TX_VALUE_SEPARATOR);
+          }
+          TxLen += ArrayCodecs[i]->Format((char*)&TxBuffer[TxLen], (const byte*)TxValue(i) + TxPartPos * size);
+          TxPartPos += 1;
+        }
+        TxPart = 4;
+        break;
       }
+      #endif
     }
   }
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-void cSerialWatcher::StringWrite(char *dst, const __FlashStringHelper *src) {
-  //the destination string should be large enough to receive the copy
-  strcpy_P(dst, (const char*) src);
-}
+#if SERIALWATCHER_TX_DELTA
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-int cSerialWatcher::StringPositionSingleChar(char *s_where, char c_char) {
-  char *pch = strchr(s_where, c_char);
-  if (pch == NULL) {
-    return -1;
+// - Slot to be sent in the stream in progress -
+// delta mode: only the changed values, refresh classes: the slots sent every n streams are spread over the streams by their slot number,
+// the slots sent only on change are compared with their shadow copy also outside the delta mode (a keyframe sends all the slots)
+//
+bool cSerialWatcher::TxDue(cSerialWatcherIndex i, bool keyframe) {
+  #if SERIALWATCHER_TX_REFRESH
+  if (!keyframe) {
+    byte shift = ArrayRefresh[i];
+    if (shift == 0xFF) {
+      return TxChanged(i, false); //on change only
+    }
+    if (((_txcount + i) & ((1 << shift) - 1)) != 0) {
+      return false; //not in this stream
+    }
   }
-  else {
-    return pch-s_where;
+  if ((_txmode & SERIALWATCHER_TX_MODE_DELTA) != SERIALWATCHER_TX_MODE_DELTA) {
+    if (ArrayRefresh[i] == 0xFF) {
+      TxChanged(i, true); //keyframe: refresh the shadow copy
+    }
+    return true;
   }
+  #endif
+  return TxChanged(i, keyframe);
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//return True if string s_what is found inside string s_where
-bool cSerialWatcher::StringSearchSubString(char *s_where, const char *s_what) {
-  if (strstr(s_where, s_what) == NULL) { 
-    return false; 
+// - Delta mode change detection -
+// the shadow copy keeps 4 bytes for each slot: the raw value when it fits, otherwise a FNV-1a digest of the value (64 bit numbers and texts)
+// returns true when the value differs from the last transmitted one (or when keyframe is true), in that case the shadow copy is updated
+//
+bool cSerialWatcher::TxChanged(cSerialWatcherIndex i, bool keyframe) {
+  byte datatype = ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE;
+  byte shadow[4] = {0, 0, 0, 0};
+  uint16_t size = pgm_read_byte(&DataTypeSize[datatype]);
+  uint16_t k;
+  #if SERIALWATCHER_TX_NUMARRAYS
+  size = size * ArrayLength(i); //numeric array: all the values
+  #endif
+  if (datatype == SERIALWATCHER_DATATYPE_achar || datatype == SERIALWATCHER_DATATYPE_flashstring || size > sizeof(shadow)) {
+    uint32_t digest = 2166136261UL; //FNV-1a offset basis
+    const char *p = (const char*)TxValue(i);
+    byte c;
+    for (k = 0; ; k++) {
+      if (datatype == SERIALWATCHER_DATATYPE_achar) {
+        c = p[k];
+      }
+      else if (datatype == SERIALWATCHER_DATATYPE_flashstring) {
+        c = pgm_read_byte(p + k);
+      }
+      else if (k < size) {
+        c = p[k];
+      }
+      else {
+        break;
+      }
+      if (c == '\0' && datatype >= SERIALWATCHER_DATATYPE_achar) {
+        break;
+      }
+      digest = (digest ^ c) * 16777619UL; //FNV-1a prime
+      if (k == 255 && datatype >= SERIALWATCHER_DATATYPE_achar) {
+        break; //texts: up to 256 chars
+      }
+    }
+    memcpy(shadow, &digest, sizeof(shadow));
   }
-  else { 
-    return true; 
+  else {
+    memcpy(shadow, TxValue(i), size);
   }
-}
-//-------------------------------------------------------------------------------------------------------------------------------------------------------------
-//return True if string s_what is found inside s_where
-bool cSerialWatcher::StringSearchSubString(const __FlashStringHelper *s_where, const char *s_what) {
-  size_t siz = strlen_P((const char*) s_where); //returns the number of characters in src (that's a pointer to an array of char in program space)
-  siz += 1; //+1 for the null terminator
-  siz = constrain(siz, 0, 256);
-  char dst[siz];
-  StringWrite(dst, s_where);
-  if (strstr(dst, s_what) == NULL) { 
-    return false; 
+  if (!keyframe) {
+    //float with deadband: changed only when it moves more than the deadband from the last transmitted value
+    if (datatype == SERIALWATCHER_DATATYPE_float) {
+      for (k = 0; k < _deadbands; k++) {
+        if (DeadbandSlots[k] == i) {
+          float last;
+          float actual;
+          memcpy(&last, ArrayShadow[i], sizeof(float));
+          memcpy(&actual, shadow, sizeof(float));
+          if (fabs(actual - last) <= DeadbandValues[k]) {
+            return false;
+          }
+          break;
+        }
+      }
+    }
+    if (memcmp(shadow, ArrayShadow[i], sizeof(shadow)) == 0) {
+      return false;
+    }
   }
-  else { 
-    return true; 
+  memcpy(ArrayShadow[i], shadow, sizeof(shadow));
+  //the value is checked only when it has changed (the flashstrings are checked when mapped)
+  if (datatype != SERIALWATCHER_DATATYPE_flashstring) {
+    CheckValue(i);
   }
+  return true;
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-#if defined(ARDUINO_AVR_UNO) || defined(ARDUINO_AVR_MEGA2560)
+#endif
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-void cSerialWatcher::print_unsigned_long_long(Stream &_serial, uint64_t val) {
-    if (val < 10) {
-         _serial.print((uint16_t) val); //find digits and print them using 
-    } else {
-        uint64_t subproblem = val / 10;
-        int16_t remainder = val % 10;
-        print_unsigned_long_long(_serial, subproblem);
-        _serial.print(remainder);
-    }
-}
+#if SERIALWATCHER_TX_BINARY
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-void cSerialWatcher::print_long_long(Stream &_serial, int64_t val) {
-    int64_t positive = val;
-    if (val < 0) {
-        _serial.print("-");
-        positive *= -1;
-    }
-    print_unsigned_long_long(_serial, positive);
+// - Binary element payload -
+// SERIALWATCHER_TX_BIN_RECORD_ELEMENT        | slot | features | value length | value | name |
+// SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT | slot | features | name |
+// SERIALWATCHER_TX_BIN_RECORD_VALUE          | slot | value |
+// numeric values are the raw little-endian bytes of the variable, texts are sent without terminator
+// the name takes the remaining bytes of the payload, texts that do not fit in the record are truncated
+//
+byte cSerialWatcher::TxBinaryElement(cSerialWatcherIndex i, byte type, byte *dst, byte room) {
+  byte len = 0;
+  byte vlen = 0;
+  dst[len++] = (byte)i;
+  if (sizeof(cSerialWatcherIndex) > 1) {
+    dst[len++] = (byte)(i >> 8); //2 bytes slot numbers
+  }
+  byte features = ArrayFeatures[i];
+  #if SERIALWATCHER_TX_FLOATENC
+  byte enc = FloatEncIndex(i);
+  if (enc != 0xFF) {
+    features = (features & ~SERIALWATCHER_FEATURES_MASK_DATATYPE) | FloatEncTypes[enc];
+  }
+  #endif
+  if (type != SERIALWATCHER_TX_BIN_RECORD_VALUE) {
+    dst[len++] = features;
+  }
+  byte vpos = len; //value length
+  if (type == SERIALWATCHER_TX_BIN_RECORD_ELEMENT) {
+    len++;
+  }
+  //value
+  if (type != SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT && 
+      (ArrayFeatures[i] & (SERIALWATCHER_FEATURES_MASK_INVALID_VALUE | SERIALWATCHER_FEATURES_MASK_ARRAY)) == 0) { //!InvalidValue, the arrays are sent by TxBinaryArray()
+    #if SERIALWATCHER_TX_FLOATENC
+    if (enc != 0xFF) {
+      vlen = TxFloatEncoded(&dst[len], enc, TxValue(i));
+    }
+    else
+    #endif
+    #if SERIALWATCHER_TX_COMPACT
+    //integers as varints (the integer datatypes are int8_t ... uint64_t)
+    if ((_txmode & SERIALWATCHER_TX_MODE_COMPACT) == SERIALWATCHER_TX_MODE_COMPACT && 
+        (ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE) >= SERIALWATCHER_DATATYPE_int8_t && 
+        (ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE) <= SERIALWATCHER_DATATYPE_uint64_t) {
+      vlen = CompactVarint(&dst[len], TxValue(i), ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE);
+    }
+    else
+    #endif
+    switch (ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE) {
+      case SERIALWATCHER_DATATYPE_achar:
+        vlen = StringCopy(&dst[len], (const char*)ArrayValues[i], room - len);
+        break;
+      case SERIALWATCHER_DATATYPE_flashstring:
+        vlen = StringCopy(&dst[len], (const __FlashStringHelper*)ArrayValues[i], room - len);
+        break;
+      default:
+        vlen = pgm_read_byte(&DataTypeSize[ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+        memcpy(&dst[len], TxValue(i), vlen); //all the supported boards are little-endian
+        break;
+    }
+  }
+  if (type == SERIALWATCHER_TX_BIN_RECORD_ELEMENT) {
+    dst[vpos] = vlen;
+  }
+  len += vlen;
+  #if SERIALWATCHER_TX_FLOATENC
+  //fixed point scale and offset
+  if (type != SERIALWATCHER_TX_BIN_RECORD_VALUE && enc != 0xFF && FloatEncTypes[enc] == SERIALWATCHER_DATATYPE_fixed16) {
+    memcpy(&dst[len], &FloatEncScales[enc], sizeof(float));
+    memcpy(&dst[len + sizeof(float)], &FloatEncOffsets[enc], sizeof(float));
+    len += 2 * sizeof(float);
+  }
+  #endif
+  //name
+  if (type != SERIALWATCHER_TX_BIN_RECORD_VALUE && 
+      (ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_INVALID_NAME) != SERIALWATCHER_FEATURES_MASK_INVALID_NAME) { //!InvalidName
+    len += StringCopy(&dst[len], ArrayNames[i], room - len);
+  }
+  return len;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_NUMARRAYS
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Numeric array values -
+// | slot | first index | as many raw little-endian values as fit in the record |, TxPartPos is the next value to send
+// returns true with the last record of the array
+//
+bool cSerialWatcher::TxBinaryArray(cSerialWatcherIndex i) {
+  uint16_t length = ArrayLength(i);
+  byte size = pgm_read_byte(&DataTypeSize[ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+  byte len = 0;
+  byte *dst = &TxBuffer[3];
+  dst[len++] = (byte)i;
+  if (sizeof(cSerialWatcherIndex) > 1) {
+    dst[len++] = (byte)(i >> 8); //2 bytes slot numbers
+  }
+  dst[len++] = (byte)TxPartPos;
+  dst[len++] = (byte)(TxPartPos >> 8);
+  #if SERIALWATCHER_TX_COMPACT
+  if ((_txmode & SERIALWATCHER_TX_MODE_COMPACT) == SERIALWATCHER_TX_MODE_COMPACT) {
+    uint16_t packed;
+    len += CompactPack(&dst[len], SERIALWATCHER_TX_ARRAY_LENGTH - 5 - len, (const byte*)TxValue(i) + TxPartPos * size, (uint32_t)(length - TxPartPos) * size, size, packed);
+    TxPartPos += packed;
+    TxBinaryRecord(SERIALWATCHER_TX_BIN_RECORD_ARRAY, len);
+    return TxPartPos >= length;
+  }
+  #endif
+  byte n = (SERIALWATCHER_TX_ARRAY_LENGTH - 5 - len) / size;
+  if (n > length - TxPartPos) {
+    n = length - TxPartPos;
+  }
+  memcpy(&dst[len], (const byte*)TxValue(i) + TxPartPos * size, n * size); //all the supported boards are little-endian
+  len += n * size;
+  TxPartPos += n;
+  TxBinaryRecord(SERIALWATCHER_TX_BIN_RECORD_ARRAY, len);
+  return TxPartPos >= length;
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-long long cSerialWatcher::atoll(char *src) {
-  bool sign_must_be_inverted = false;
-  byte m = 0;
-  if(src[0]=='-') {
-    sign_must_be_inverted = true;
-    m = 1;
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_FLOATENC
+byte cSerialWatcher::FloatEncIndex(cSerialWatcherIndex i) {
+  for (byte k = 0; k < _floatencs; k++) {
+    if (FloatEncSlots[k] == i) {
+      return k;
+    }
+  }
+  return 0xFF; //raw
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+byte cSerialWatcher::TxFloatEncoded(byte *dst, byte k, const void *value) {
+  float v;
+  memcpy(&v, value, sizeof(v));
+  if (FloatEncTypes[k] == SERIALWATCHER_DATATYPE_half) {
+    uint16_t h = FloatToHalf(v);
+    dst[0] = (byte)h;
+    dst[1] = (byte)(h >> 8);
+    return 2;
+  }
+  float x = (v - FloatEncOffsets[k]) / FloatEncScales[k];
+  int16_t raw;
+  if (!(x > -32768.0f)) { //nan included
+    raw = -32768;
+  }
+  else if (!(x < 32767.0f)) {
+    raw = 32767;
+  }
+  else {
+    raw = (int16_t)(x + (x >= 0 ? 0.5f : -0.5f)); //rounded
+  }
+  #if SERIALWATCHER_TX_COMPACT
+  if ((_txmode & SERIALWATCHER_TX_MODE_COMPACT) == SERIALWATCHER_TX_MODE_COMPACT) {
+    return CompactVarint(dst, &raw, SERIALWATCHER_DATATYPE_int16_t);
+  }
+  #endif
+  dst[0] = (byte)raw;
+  dst[1] = (byte)((uint16_t)raw >> 8);
+  return 2;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Transmit one binary record -
+// the payload is expected already in TxBuffer[3 ...], the record is completed and COBS encoded in place, then TxFlush() sends it
+//
+//   before encoding: | 0 | type | len | payload ... | checksum |
+//   after encoding:  | code | type | len | payload ... | checksum | 0x00 |
+//
+// COBS (consistent overhead byte stuffing) replaces each zero with the distance to the next zero,
+// so the delimiter can only appear at the end of the record and the pc-app can always resync on it
+//
+void cSerialWatcher::TxBinaryRecord(byte type, byte len) {
+  byte n = len + 3; //type + len + payload + checksum
+  byte sum = 0;
+  byte k;
+  TxBuffer[1] = type;
+  TxBuffer[2] = len;
+  for (k = 1; k < n; k++) {
+    sum += TxBuffer[k];
   }
-  long long ret = 0;
-  char digit[2];
-  digit[1] = '\0';
+  TxBuffer[n] = (byte)(0 - sum); //checksum: the sum of all the record bytes is zero
+  //COBS encoding, from the end of the record to the beginning
+  byte last = n + 1; //position of the delimiter
+  for (k = n; k > 0; k--) {
+    if (TxBuffer[k] == SERIALWATCHER_TX_BIN_DELIMITER) {
+      TxBuffer[k] = last - k;
+      last = k;
+    }
+  }
+  TxBuffer[0] = last;
+  TxBuffer[n + 1] = SERIALWATCHER_TX_BIN_DELIMITER;
+  TxLen = n + 2; //sent by TxFlush()
+  TxPos = 0;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_ALARM
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Check the watch conditions -
+// an alarm is pending from the edge of its condition until it is sent, if the condition changes again before the alarm is sent
+// the first edge is reported, then the current state (a short alarm is never lost)
+//
+void cSerialWatcher::AlarmCheck() {
+  for (byte k = 0; k < _alarms; k++) {
+    cSerialWatcherIndex i = AlarmSlots[k];
+    byte datatype = ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE;
+    byte bit = 1 << k;
+    bool raised;
+    switch (AlarmConditions[k]) {
+      case SERIALWATCHER_ALARM_ABOVE:
+        raised = AlarmValue(datatype, ArrayValues[i]) > AlarmLimits[k];
+        break;
+      case SERIALWATCHER_ALARM_BELOW:
+        raised = AlarmValue(datatype, ArrayValues[i]) < AlarmLimits[k];
+        break;
+      case SERIALWATCHER_ALARM_MASK:
+        raised = ((uint32_t)AlarmRaw(ArrayValues[i], pgm_read_byte(&DataTypeSize[datatype])) & AlarmBits[k]) != 0;
+        break;
+      default: { //SERIALWATCHER_ALARM_CHANGE, every change is an alarm
+        uint64_t raw = AlarmRaw(ArrayValues[i], pgm_read_byte(&DataTypeSize[datatype]));
+        uint32_t digest = (uint32_t)raw ^ (uint32_t)(raw >> 32);
+        //once for each stream, a held change is sent in the next stream with the latest value
+        if (digest != AlarmBits[k] && (_alarmheld & bit) != bit) {
+          AlarmBits[k] = digest;
+          _alarmreport = _alarmreport | bit; //SET
+          _alarmpending = _alarmpending | bit; //SET
+        }
+        continue;
+      }
+    }
+    if (raised == ((_alarmstate & bit) == bit)) {
+      continue; //no edge
+    }
+    _alarmstate = _alarmstate ^ bit;
+    if ((_alarmpending & bit) != bit) {
+      _alarmreport = (_alarmreport & ~bit) | (_alarmstate & bit);
+      _alarmpending = _alarmpending | bit; //SET
+    }
+  }
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Send the first pending alarm -
+// ascii ^slot"state"value"features; binary | slot | state | features | value (raw) |, the value is the one at the time of the alarm element
+// the alarms are sent also for the slots not subscribed or out of the page
+//
+void cSerialWatcher::TxAlarm() {
+  byte k = 0;
+  while ((_alarmpending & (1 << k)) == 0) {
+    k++;
+  }
+  byte bit = 1 << k;
+  cSerialWatcherIndex i = AlarmSlots[k];
+  byte state = ((_alarmreport & bit) == bit) ? 1 : 0;
+  _alarmpending = _alarmpending &~ bit; //CLEAR
+  if (AlarmConditions[k] == SERIALWATCHER_ALARM_CHANGE) {
+    _alarmheld = _alarmheld | bit; //SET
+  }
+  //the condition changed again after the first edge: its current state follows
+  if (AlarmConditions[k] != SERIALWATCHER_ALARM_CHANGE && state != (((_alarmstate & bit) == bit) ? 1 : 0)) {
+    _alarmreport = _alarmreport ^ bit;
+    _alarmpending = _alarmpending | bit; //SET
+  }
+  #if SERIALWATCHER_TX_BINARY
+  if ((_txmode & SERIALWATCHER_TX_MODE_BINARY) == SERIALWATCHER_TX_MODE_BINARY) {
+    byte size = pgm_read_byte(&DataTypeSize[ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+    byte len = 0;
+    TxBuffer[3 + len++] = (byte)i;
+    if (sizeof(cSerialWatcherIndex) > 1) {
+      TxBuffer[3 + len++] = (byte)(i >> 8); //2 bytes slot numbers
+    }
+    TxBuffer[3 + len++] = state;
+    TxBuffer[3 + len++] = ArrayFeatures[i];
+    memcpy(&TxBuffer[3 + len], ArrayValues[i], size);
+    TxBinaryRecord(SERIALWATCHER_TX_BIN_RECORD_ALARM, len + size);
+    return;
+  }
+  #endif
+  TxPut(F(SERIALWATCHER_TX_CODE_ALARM));
+  TxLen += FormatUnsigned((char*)&TxBuffer[TxLen], (uint32_t)i);
+  TxPut(*SERIALWATCHER_TX_FIELD_SEPARATOR);
+  TxPut((char)('0' + state));
+  TxPut(*SERIALWATCHER_TX_FIELD_SEPARATOR);
+  TxLen += ArrayCodecs[i]->Format((char*)&TxBuffer[TxLen], ArrayValues[i]);
+  TxPut(*SERIALWATCHER_TX_FIELD_SEPARATOR);
+  TxLen += FormatUnsigned((char*)&TxBuffer[TxLen], (uint32_t)ArrayFeatures[i]);
+  TxPut(*SERIALWATCHER_TX_ELEMENT_SEPARATOR);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_SUBSCRIBE
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - First subscribed slot of the stream from i on -
+// the bitmap is read one byte at a time, so 8 slots not subscribed are skipped with a single test
+//
+cSerialWatcherIndex cSerialWatcher::TxSubscribed(cSerialWatcherIndex i) {
+  uint32_t k = i; //the next byte can be beyond the last slot number
+  while (k < TxSlotEnd) {
+    byte bits = ArraySubscribed[k >> 3] >> (k & 7);
+    if (bits != 0) {
+      while ((bits & 1) == 0) {
+        bits >>= 1;
+        k++;
+      }
+      return (k < TxSlotEnd) ? k : TxSlotEnd; //the bits after the last mapped slot are not used
+    }
+    k = (k | 7) + 1; //next byte
+  }
+  return TxSlotEnd;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Subscription of a list of slots -
+// list is the comma separated list of the slots and the ranges of slots, for example "0-15,40", * = all the mapped slots
+// the whole list is checked before the first change, so the subscription is not modified in case of error
+//
+byte cSerialWatcher::RxSubscribe(byte op, const char *list) {
+  if (*list == '\0') {
+    return SERIALWATCHER_RX_ERROR_VALUE;
+  }
+  for (byte pass = 0; pass < 2; pass++) { //check, then apply
+    const char *src = list;
+    if (pass == 1 && op == SERIALWATCHER_SUBSCRIBE_REPLACE) {
+      TxSubscribe(0, 0xFFFF, false);
+    }
+    while (*src != '\0') {
+      uint16_t first = 0;
+      uint16_t last = 0xFFFF;
+      if (*src == '*') {
+        src++;
+      }
+      else {
+        if (!ListNumber(src, first)) {
+          return SERIALWATCHER_RX_ERROR_VALUE;
+        }
+        last = first;
+        if (*src == '-') {
+          src++;
+          if (!ListNumber(src, last) || last < first) {
+            return SERIALWATCHER_RX_ERROR_VALUE;
+          }
+        }
+        if (last >= SlotCount) {
+          return SERIALWATCHER_RX_ERROR_SLOT;
+        }
+      }
+      if (*src == ',') {
+        src++;
+      }
+      else if (*src != '\0') {
+        return SERIALWATCHER_RX_ERROR_VALUE;
+      }
+      if (pass == 1) {
+        TxSubscribe(first, last, op != SERIALWATCHER_SUBSCRIBE_REMOVE);
+      }
+    }
+  }
+  return SERIALWATCHER_RX_OK;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//value of a hex digit (0xFF = not a hex digit)
+static byte HexDigit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return 0xFF;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Subscription bitmap -
+// hex are the bytes of the bitmap from the slot first on, two hex digits each (bit 0 = slot first), for example <K"8"FF0F> sends the slots 8 ... 15 and 16 ... 19
+// and skips the slots 20 ... 23, the other slots are unchanged. A big table is sent in more commands (12 bytes = 96 slots each)
+//
+byte cSerialWatcher::RxSubscribeMap(uint16_t first, const char *hex) {
+  byte len = strlen(hex);
+  if ((first & 7) != 0 || len == 0 || (len & 1) != 0) {
+    return SERIALWATCHER_RX_ERROR_VALUE;
+  }
+  if (first / 8 + len / 2 > (SlotCount + 7) / 8) {
+    return SERIALWATCHER_RX_ERROR_SLOT;
+  }
+  for (byte n = 0; n < len; n++) {
+    if (HexDigit(hex[n]) == 0xFF) {
+      return SERIALWATCHER_RX_ERROR_VALUE;
+    }
+  }
+  for (byte n = 0; n < len; n += 2) {
+    ArraySubscribed[first / 8 + n / 2] = (byte)((HexDigit(hex[n]) << 4) | HexDigit(hex[n + 1]));
+  }
+  #if SERIALWATCHER_TX_DELTA
+  _txframe = 0; //the slots subscribed again are sent in a keyframe
+  #endif
+  return SERIALWATCHER_RX_OK;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_SCOPE
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Start (or stop) the scope mode -
+// list is the comma separated list of the sampled slots, for example "3,4", they must be mapped numeric slots
+// the ring buffer is cleared and its capacity is the number of whole samples that fit in SERIALWATCHER_SCOPE_BUFFER
+//
+byte cSerialWatcher::ScopeStart(byte decimation, const char *list) {
+  cSerialWatcherIndex slots[SERIALWATCHER_SCOPE_SLOTS];
+  byte count = 0;
+  uint16_t size = 0;
+  _scopedecimation = 0; //stopped, also in case of error
+  _scopecount = 0;
+  if (decimation == 0) {
+    return SERIALWATCHER_RX_OK;
+  }
+  if ((_txmoderequest & SERIALWATCHER_TX_MODE_BINARY) != SERIALWATCHER_TX_MODE_BINARY) {
+    return SERIALWATCHER_RX_ERROR_COMMAND; //the bursts are binary records, nothing would be sent in ascii mode
+  }
+  while (*list != '\0') {
+    uint16_t slot;
+    if (count >= SERIALWATCHER_SCOPE_SLOTS || !ListNumber(list, slot)) {
+      return SERIALWATCHER_RX_ERROR_VALUE;
+    }
+    if (*list == ',') {
+      list++;
+    }
+    else if (*list != '\0') {
+      return SERIALWATCHER_RX_ERROR_VALUE;
+    }
+    if (slot >= SlotCount) {
+      return SERIALWATCHER_RX_ERROR_SLOT;
+    }
+    byte vlen = pgm_read_byte(&DataTypeSize[ArrayFeatures[slot] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+    if (vlen == 0 || (ArrayFeatures[slot] & SERIALWATCHER_FEATURES_MASK_ARRAY) == SERIALWATCHER_FEATURES_MASK_ARRAY) {
+      return SERIALWATCHER_RX_ERROR_DATATYPE; //texts and arrays can't be sampled
+    }
+    slots[count++] = slot;
+    size += vlen;
+  }
+  //at least one sample must fit in a burst: | sequence | lost | sample |
+  if (count == 0 || size > SERIALWATCHER_TX_ARRAY_LENGTH - 5 - 4 || size > SERIALWATCHER_SCOPE_BUFFER) {
+    return SERIALWATCHER_RX_ERROR_VALUE;
+  }
+  memcpy(ScopeSlots, slots, count * sizeof(cSerialWatcherIndex));
+  _scopeslots = count;
+  _scopesize = size;
+  _scopecapacity = SERIALWATCHER_SCOPE_BUFFER / size;
+  _scopehead = 0;
+  _scopetail = 0;
+  _scopeseq = 0;
+  _scopelost = 0;
+  _scopetick = 0;
+  _scopeburst = 0;
+  _scopedecimation = decimation;
+  return SERIALWATCHER_RX_OK;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Append one sample to the ring buffer, every _scopedecimation updates -
+// with the ring buffer full the new sample is dropped and counted as lost, the samples already stored keep their order
+//
+void cSerialWatcher::ScopeSample() {
+  _scopetick += 1;
+  if (_scopetick < _scopedecimation) {
+    return;
+  }
+  _scopetick = 0;
+  if (_scopecount >= _scopecapacity) {
+    _scopelost += 1;
+    return;
+  }
+  byte *dst = &ScopeBuffer[_scopehead * _scopesize];
+  for (byte k = 0; k < _scopeslots; k++) {
+    cSerialWatcherIndex i = ScopeSlots[k];
+    byte vlen = pgm_read_byte(&DataTypeSize[ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+    memcpy(dst, ArrayValues[i], vlen); //raw little-endian value
+    dst += vlen;
+  }
+  _scopehead = (_scopehead + 1 == _scopecapacity) ? 0 : _scopehead + 1;
+  _scopecount += 1;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Send the oldest samples in one SERIALWATCHER_TX_BIN_RECORD_SCOPE record -
+// payload: | sequence | lost | as many samples as fit in TxBuffer |
+//
+void cSerialWatcher::TxScopeBurst() {
+  byte n = (SERIALWATCHER_TX_ARRAY_LENGTH - 5 - 4) / _scopesize;
+  if (n > _scopecount) {
+    n = _scopecount;
+  }
+  TxBuffer[3] = (byte)_scopeseq;
+  TxBuffer[4] = (byte)(_scopeseq >> 8);
+  TxBuffer[5] = (byte)_scopelost;
+  TxBuffer[6] = (byte)(_scopelost >> 8);
+  byte len = 4;
+  for (byte k = 0; k < n; k++) {
+    memcpy(&TxBuffer[3 + len], &ScopeBuffer[_scopetail * _scopesize], _scopesize);
+    len += _scopesize;
+    _scopetail = (_scopetail + 1 == _scopecapacity) ? 0 : _scopetail + 1;
+  }
+  _scopecount -= n;
+  _scopeseq += n;
+  _scopeburst += n;
+  TxBinaryRecord(SERIALWATCHER_TX_BIN_RECORD_SCOPE, len);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Value to be sent -
+// with the snapshot the numeric values come from the copy taken at the stream start, the slots are sent in increasing order
+// so the read cursor only moves forward (the slots before the cursor and the ones not copied are read from the variables)
+//
+const void *cSerialWatcher::TxValue(cSerialWatcherIndex i) {
+  #if SERIALWATCHER_TX_SNAPSHOT
+  if (i >= _snapshotslot && i < _snapshotend) {
+    uint16_t size;
+    while (_snapshotslot < i) {
+      size = SnapshotSize(_snapshotslot);
+      if (size != 0) {
+        byte align = pgm_read_byte(&DataTypeSize[ArrayFeatures[_snapshotslot] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+        _snapshotpos = ((_snapshotpos + align - 1) & ~(uint16_t)(align - 1)) + size;
+      }
+      _snapshotslot += 1;
+    }
+    if (SnapshotSize(i) != 0) {
+      byte align = pgm_read_byte(&DataTypeSize[ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+      return (const byte*)_snapshot + ((_snapshotpos + align - 1) & ~(uint16_t)(align - 1));
+    }
+  }
+  #endif
+  return ArrayValues[i];
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_SNAPSHOT
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Snapshot of the numeric values of the stream -
+// one pass with the interrupts disabled, so no value is torn by an ISR and all of them belong to the same loop
+// each value is aligned to the size of its datatype (the codecs read the value through a typed pointer), the copy stops at the first value that doesn't fit
+//
+void cSerialWatcher::TxSnapshot() {
+  uint16_t pos = 0;
+  cSerialWatcherIndex i;
+  _snapshotslot = TxSlot;
+  _snapshotpos = 0;
+  noInterrupts();
+  for (i = TxSlot; i < TxSlotEnd; i++) {
+    uint16_t size = SnapshotSize(i);
+    if (size != 0) {
+      byte align = pgm_read_byte(&DataTypeSize[ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+      pos = (pos + align - 1) & ~(uint16_t)(align - 1);
+      if (pos + size > sizeof(_snapshot)) {
+        break;
+      }
+      memcpy((byte*)_snapshot + pos, ArrayValues[i], size);
+      pos += size;
+    }
+  }
+  interrupts();
+  _snapshotend = i;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//bytes of the slot in the snapshot: the numbers (and the numeric arrays), the chars and the texts are read when sent
+uint16_t cSerialWatcher::SnapshotSize(cSerialWatcherIndex i) {
+  byte datatype = ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE;
+  if (datatype >= SERIALWATCHER_DATATYPE_char) {
+    return 0;
+  }
+  #if SERIALWATCHER_TX_NUMARRAYS
+  return pgm_read_byte(&DataTypeSize[datatype]) * ArrayLength(i);
+  #else
+  return pgm_read_byte(&DataTypeSize[datatype]);
+  #endif
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Receive data from PC with start and end markers combined with parsing -
+// based on snipped code from https://forum.arduino.cc/index.php?topic=396450
+// this function expects to receive data from pc in this format <DataType:ArrayPlace:Value>, where
+// <          is the stream start
+// DataType   is the data type
+// ArrayPlace is the array place
+// Value      is the value
+// >          is the stream end
+// for example <b:12:0.0> is splitted as:   b DataType | 12 ArrayPlace | 0     Value
+// for example <i:12:37.0> is splitted as:  i DataType | 12 ArrayPlace | 37    Value
+// for example <f:12:86.42> is splitted as: f DataType | 12 ArrayPlace | 86.42 Value
+// for example <s:12:text> is splitted as:  s DataType | 12 ArrayPlace | text  Value
+//
+// all the available chars are read (up to SERIALWATCHER_RX_MAX_READ for each update), so a command is applied in the same loop it arrives
+// the command is decoded in a single pass while the chars arrive: DataType and ArrayPlace are decoded on the fly, only Value is stored in RxBuffer
+//
+void cSerialWatcher::Rx() {
   byte n = 0;
-  while(src[n+m] != '\0') {    
-    digit[0] = src[n+m];
-    if(n!=0) {
-      ret *= 10;
-    }  
-    ret += atoi(digit);
+  while (n < SERIALWATCHER_RX_MAX_READ && _serial->available() > 0) { //only when receive data
+    char c = _serial->read(); //read the incoming char
     n++;
+    if ((_mem & SERIALWATCHER_MEMO_RX_STREAM) != SERIALWATCHER_MEMO_RX_STREAM) { //rx not in progress
+      if (c == SERIALWATCHER_RX_CODE_STREAM_START) {
+        _mem = _mem | SERIALWATCHER_MEMO_RX_STREAM; //SET
+        RxLen = 0;
+        RxFields = 0;
+        RxType = '\0';
+        RxSlot = 0xFFFF; //no digits
+        RxStatus = SERIALWATCHER_RX_OK;
+        #if SERIALWATCHER_RX_BATCH
+        RxPairs = 0;
+        if (_batchstate == SERIALWATCHER_RX_BATCH_COMMIT) {
+          RxCommit(); //previous batch not yet applied (more commands in the same Update()), the commands are applied in order
+        }
+        #endif
+      }
+    }
+    else if (c == SERIALWATCHER_RX_CODE_STREAM_END) { //stream end
+      //terminate the string
+      RxBuffer[RxLen] = '\0';
+      _mem = _mem &~ SERIALWATCHER_MEMO_RX_STREAM; //CLEAR
+      if (RxStatus == SERIALWATCHER_RX_OK) {
+        RxStatus = RxParse();
+      }
+      _rxerror = RxStatus;
+      #if SERIALWATCHER_PROFILE
+      if (RxStatus != SERIALWATCHER_RX_OK && _proferrors < 0xFFFF) {
+        _proferrors += 1;
+      }
+      if (RxStatus == SERIALWATCHER_RX_ERROR_OVERFLOW && _profoverflows < 0xFFFF) {
+        _profoverflows += 1;
+      }
+      #endif
+      #if SERIALWATCHER_RX_BATCH
+      if (RxPairs != 0) {
+        RxBatchEnd();
+      }
+      #endif
+    }
+    #if SERIALWATCHER_RX_BATCH
+    else if (c == SERIALWATCHER_RX_BATCH_SEPARATOR) { //end of a write of a batch
+      if (RxPairs == 0) { //first write: new batch
+        _batchcount = 0;
+      }
+      RxPairs += (RxPairs < 0xFF) ? 1 : 0;
+      RxBuffer[RxLen] = '\0';
+      if (RxStatus == SERIALWATCHER_RX_OK) {
+        RxStatus = RxParse();
+      }
+      RxLen = 0;
+      RxFields = 0;
+      RxType = '\0';
+      RxSlot = 0xFFFF;
+    }
+    #endif
+    else if (c == SERIALWATCHER_RX_FIELD_SEPARATOR) { //end of field
+      if (RxFields < 2) {
+        RxFields += 1;
+      }
+      else {
+        RxStatus = SERIALWATCHER_RX_ERROR_FORMAT;
+      }
+    }
+    else { //rx in progress
+      switch (RxFields) {
+        //DataType - max one character
+        case 0:
+          if (RxType != '\0') {
+            RxStatus = SERIALWATCHER_RX_ERROR_FORMAT;
+          }
+          RxType = c;
+          break;
+        //ArrayPlace - decimal digits
+        case 1:
+          if (c < '0' || c > '9') {
+            RxStatus = SERIALWATCHER_RX_ERROR_FORMAT;
+          }
+          else if (RxSlot == 0xFFFF) {
+            RxSlot = c - '0';
+          }
+          else if (RxSlot <= (0xFFFE - (c - '0')) / 10) {
+            RxSlot = RxSlot * 10 + (c - '0'); //up to 0xFFFE (0xFFFF = no digits)
+          }
+          else {
+            RxStatus = SERIALWATCHER_RX_ERROR_SLOT; //too many digits: the command is discarded
+          }
+          break;
+        //Value - collected in RxBuffer
+        default:
+          if (RxLen < (SERIALWATCHER_RX_ARRAY_LENGTH -1)) {
+            RxBuffer[RxLen] = c; //collect character
+            RxLen += 1;
+          }
+          else {
+            //error: rx buffer lenght overflow
+            #if SERIALWATCHER_RX_ADV_DIAGNOSTICS //to enable advanced diagnostics edit #define at the beginning of this file
+              _serial->println();
+              _serial->print(F("Error! Rx Buffer Lenght Overflow"));
+              delay(5000);
+            #endif
+            RxStatus = SERIALWATCHER_RX_ERROR_OVERFLOW;
+          }
+          break;
+      }
+    }
+  }
+  #if SERIALWATCHER_PROFILE
+  _profrxbytes += n;
+  #endif
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Parse and apply a complete command -
+// RxType, RxSlot and the Value in RxBuffer are checked against the mapped variable before writing it
+// returns SERIALWATCHER_RX_OK or the SERIALWATCHER_RX_ERROR_* code, the variable is not modified in case of error
+//
+byte cSerialWatcher::RxParse() {
+  char *Value = RxBuffer;
+  //: diagnostics
+  #if SERIALWATCHER_RX_ADV_DIAGNOSTICS //to enable advanced diagnostics edit #define at the beginning of this file
+    _serial->println();
+    _serial->print(F("DataType "));
+    _serial->println(RxType);
+    _serial->print(F("ArrayPlace "));
+    _serial->println(RxSlot);
+    _serial->print(F("Value "));
+    _serial->println(Value);
+    _serial->println();
+    delay(5000); //add a big delay to let the user evaluate the printed out results 
+  #endif
+  if (RxFields != 2 || RxSlot == 0xFFFF) {
+    return SERIALWATCHER_RX_ERROR_FORMAT;
+  }
+  //: datatype of the rx code (sizeof(RxCodes) = control command or unknown code)
+  byte datatype = 0;
+  while (datatype < sizeof(RxCodes) && pgm_read_byte(&RxCodes[datatype]) != RxType) {
+    datatype++;
+  }
+  #if SERIALWATCHER_RX_BATCH
+  if (RxPairs != 0 && datatype >= sizeof(RxCodes)) {
+    return SERIALWATCHER_RX_ERROR_COMMAND; //only the variables can be written in a batch
+  }
+  #endif
+  //: control commands (ArrayPlace is not used)
+  if (RxType == SERIALWATCHER_RX_CODE_STREAM_txmode) {
+    uint64_t mode;
+    if (!ParseUnsigned(Value, 0xFF, mode)) {
+      return SERIALWATCHER_RX_ERROR_VALUE;
+    }
+    this->TxMode(mode);
+    return SERIALWATCHER_RX_OK;
+  }
+  if (RxType == SERIALWATCHER_RX_CODE_STREAM_page) {
+    uint64_t page;
+    if (!ParseUnsigned(Value, 0xFFFF, page)) {
+      return SERIALWATCHER_RX_ERROR_VALUE;
+    }
+    if (RxSlot != 0 && (uint32_t)page * RxSlot >= SlotCount) {
+      return SERIALWATCHER_RX_ERROR_SLOT; //no slots in the page
+    }
+    this->TxPage(RxSlot, page);
+    return SERIALWATCHER_RX_OK;
+  }
+  #if SERIALWATCHER_TX_SCHEMA
+  if (RxType == SERIALWATCHER_RX_CODE_STREAM_schema) {
+    _mem = _mem | SERIALWATCHER_MEMO_TX_SCHEMA_REQUEST; //SET
+    return SERIALWATCHER_RX_OK;
+  }
+  #endif
+  #if SERIALWATCHER_TX_SUBSCRIBE
+  if (RxType == SERIALWATCHER_RX_CODE_STREAM_subscribe) {
+    if (RxSlot > SERIALWATCHER_SUBSCRIBE_REMOVE) {
+      return SERIALWATCHER_RX_ERROR_VALUE;
+    }
+    return RxSubscribe(RxSlot, Value);
+  }
+  if (RxType == SERIALWATCHER_RX_CODE_STREAM_subscribemap) {
+    return RxSubscribeMap(RxSlot, Value);
+  }
+  #endif
+  #if SERIALWATCHER_SCOPE
+  if (RxType == SERIALWATCHER_RX_CODE_STREAM_scope) {
+    if (RxSlot > 0xFF) {
+      return SERIALWATCHER_RX_ERROR_VALUE;
+    }
+    return ScopeStart(RxSlot, Value);
+  }
+  #endif
+  if (datatype >= sizeof(RxCodes)) {
+    return SERIALWATCHER_RX_ERROR_COMMAND;
+  }
+  //: the slot must be mapped, with the same datatype and writable
+  if (RxSlot >= SlotCount) {
+    return SERIALWATCHER_RX_ERROR_SLOT;
+  }
+  cSerialWatcherIndex ArrayPlace = RxSlot;
+  if ((ArrayFeatures[ArrayPlace] & SERIALWATCHER_FEATURES_MASK_DATATYPE) != datatype) {
+    return SERIALWATCHER_RX_ERROR_DATATYPE;
+  }
+  if ((ArrayFeatures[ArrayPlace] & SERIALWATCHER_FEATURES_MASK_READONLY) == SERIALWATCHER_FEATURES_MASK_READONLY) {
+    return SERIALWATCHER_RX_ERROR_READONLY;
+  }
+  if (RxLen == 0 && datatype != SERIALWATCHER_DATATYPE_achar) {
+    return SERIALWATCHER_RX_ERROR_VALUE; //only a text can be empty
+  }
+  #if SERIALWATCHER_RX_BATCH
+  if (RxPairs != 0) {
+    return RxStage(ArrayPlace, Value);
+  }
+  #endif
+  #if SERIALWATCHER_TX_NUMARRAYS
+  if ((ArrayFeatures[ArrayPlace] & SERIALWATCHER_FEATURES_MASK_ARRAY) == SERIALWATCHER_FEATURES_MASK_ARRAY) {
+    return RxArray(ArrayPlace, Value);
+  }
+  #endif
+  //: the text and its terminator must fit the mapped array of chars
+  if (datatype == SERIALWATCHER_DATATYPE_achar && strlen(Value) >= ArrayTextSizes[ArrayPlace]) {
+    return SERIALWATCHER_RX_ERROR_OVERFLOW;
+  }
+  //: write variables ----> put data inside variables using pointers
+  if (!ArrayCodecs[ArrayPlace]->Parse(Value, ArrayValues[ArrayPlace])) {
+    return SERIALWATCHER_RX_ERROR_VALUE;
+  }
+  CheckValue(ArrayPlace);
+  return SERIALWATCHER_RX_OK;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_TX_NUMARRAYS
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Write one value or a range of values of a numeric array -
+// Value is index:value,value ... , for example <i"3"4:10,11,12> writes the values 4, 5 and 6 of the int16_t array in slot 3
+// all the values are checked before writing, so the array is not modified in case of error
+//
+byte cSerialWatcher::RxArray(cSerialWatcherIndex i, char *Value) {
+  uint16_t length = ArrayLength(i);
+  byte size = pgm_read_byte(&DataTypeSize[ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+  uint16_t index;
+  uint16_t count = 0;
+  uint64_t scratch; //big enough for any numeric value
+  const char *src = Value;
+  char *values;
+  char *p;
+  //: index
+  if (!ListNumber(src, index) || *src != ':' || index >= length) {
+    return SERIALWATCHER_RX_ERROR_INDEX;
+  }
+  Value += src - Value + 1;
+  values = Value;
+  //: check all the values (the separators become terminators)
+  for (p = Value; ; p++) {
+    if (*p == ',' || *p == '\0') {
+      bool last = (*p == '\0');
+      *p = '\0';
+      if (*Value == '\0' || !ArrayCodecs[i]->Parse(Value, &scratch)) {
+        return SERIALWATCHER_RX_ERROR_VALUE;
+      }
+      count += 1;
+      Value = p + 1;
+      if (last) {
+        break;
+      }
+    }
+  }
+  if ((uint32_t)index + count > length) {
+    return SERIALWATCHER_RX_ERROR_INDEX;
+  }
+  //: write
+  Value = values;
+  for (uint16_t k = 0; k < count; k++) {
+    ArrayCodecs[i]->Parse(Value, (byte*)ArrayValues[i] + (index + k) * size);
+    Value += strlen(Value) + 1;
+  }
+  return SERIALWATCHER_RX_OK;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#if SERIALWATCHER_RX_BATCH
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Batched writes -
+// each write of <i"3"10|f"4"0.5|b"7"1> is checked and its value is staged when its separator (or the stream end) arrives,
+// the staged values are written together at the start of the next Update(), so the loop never sees a half updated set
+// with an error no variable is modified, either way a single acknowledge is sent at the next stream start
+//
+byte cSerialWatcher::RxStage(cSerialWatcherIndex i, const char *Value) {
+  byte size = pgm_read_byte(&DataTypeSize[ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE]);
+  if (size == 0 || (ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_ARRAY) == SERIALWATCHER_FEATURES_MASK_ARRAY) {
+    return SERIALWATCHER_RX_ERROR_DATATYPE; //texts and arrays are written one at a time
+  }
+  if (_batchcount >= SERIALWATCHER_RX_BATCH_MAX) {
+    return SERIALWATCHER_RX_ERROR_BATCH;
+  }
+  if (!ArrayCodecs[i]->Parse(Value, &_batchvalues[_batchcount])) {
+    return SERIALWATCHER_RX_ERROR_VALUE;
   }
-  if (sign_must_be_inverted) {
-    return ret*-1;
+  _batchslots[_batchcount] = i;
+  _batchcount += 1;
+  return SERIALWATCHER_RX_OK;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcher::RxBatchEnd() {
+  _batchseq += 1;
+  _batchresult = RxStatus;
+  if (RxStatus == SERIALWATCHER_RX_OK) {
+    _batchstate = SERIALWATCHER_RX_BATCH_COMMIT;
   }
   else {
-    return ret;
+    _batchcount = 0; //all or nothing
+    _batchstate = SERIALWATCHER_RX_BATCH_ACK;
+  }
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+void cSerialWatcher::RxCommit() {
+  for (byte k = 0; k < _batchcount; k++) {
+    cSerialWatcherIndex i = _batchslots[k];
+    memcpy(ArrayValues[i], &_batchvalues[k], pgm_read_byte(&DataTypeSize[ArrayFeatures[i] & SERIALWATCHER_FEATURES_MASK_DATATYPE]));
+    CheckValue(i);
+  }
+  _batchstate = SERIALWATCHER_RX_BATCH_ACK;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+#endif
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//result of the last rx command: SERIALWATCHER_RX_OK or SERIALWATCHER_RX_ERROR_*
+byte cSerialWatcher::RxError() {
+  return _rxerror;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Decimal text to number -
+// shared by all the integer datatypes: optional sign and decimal digits only, the whole text must be a number inside min ... max
+// the digits are accumulated in 32 bit while the value is small (much faster on 8 bit boards) and in 64 bit after,
+// checking the overflow before every step. true=valid
+//
+bool cSerialWatcher::ParseSigned(const char *src, int64_t min, int64_t max, int64_t &val) {
+  bool negative = (*src == '-');
+  if (negative || *src == '+') {
+    src++;
+  }
+  uint64_t magnitude;
+  //the magnitude limit of a negative number is -min (computed in unsigned, -INT64_MIN does not fit an int64_t)
+  if (!ParseUnsigned(src, negative ? (uint64_t)0 - (uint64_t)min : (uint64_t)max, magnitude)) {
+    return false;
+  }
+  val = negative ? (int64_t)((uint64_t)0 - magnitude) : (int64_t)magnitude;
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+bool cSerialWatcher::ParseUnsigned(const char *src, uint64_t max, uint64_t &val) {
+  if (*src == '\0') {
+    return false; //no digits
+  }
+  uint32_t small = 0;
+  while (*src >= '0' && *src <= '9' && small < 429496729UL) { //small * 10 + 9 still fits 32 bit
+    small = small * 10 + (*src - '0');
+    src++;
+  }
+  uint64_t v = small;
+  while (*src != '\0') {
+    if (*src < '0' || *src > '9') {
+      return false;
+    }
+    byte digit = *src - '0';
+    if (digit > max || v > (max - digit) / 10) {
+      return false; //overflow
+    }
+    v = v * 10 + digit;
+    src++;
+  }
+  if (v > max) {
+    return false;
+  }
+  val = v;
+  return true;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+byte cSerialWatcher::StringCopy(byte *dst, const char *src, byte room) {
+  byte n = 0;
+  while (n < room && src[n] != '\0') {
+    dst[n] = src[n];
+    n++;
   }
+  return n;
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-unsigned long long cSerialWatcher::atoull(char *src) {
-  unsigned long long ret = 0;
-  char digit[2];
-  digit[1] = '\0';
+byte cSerialWatcher::StringCopy(byte *dst, const __FlashStringHelper *src, byte room) {
+  const char *p = (const char*) src;
   byte n = 0;
-  while(src[n] != '\0') {    
-    digit[0] = src[n];
-    if(n!=0) {
-      ret *= 10;
-    }  
-    ret += atoi(digit);
+  char c;
+  while (n < room && (c = pgm_read_byte(p + n)) != '\0') {
+    dst[n] = c;
     n++;
   }
-  return ret;
+  return n;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// - Number formatting -
+// the number is written in dst (without terminator), same text of Serial.print(), returns the number of chars
+// the digits are written two at a time from the DigitPairs table: at most two 32 bit divisions for a 32 bit value
+// and two 64 bit divisions for a 64 bit value, instead of one division for every digit
+//
+byte cSerialWatcher::FormatUnsigned(char *dst, uint32_t val) {
+  if (val < 10000UL) {
+    return Format4Digits(dst, val, false);
+  }
+  byte k;
+  if (val < 100000000UL) {
+    uint16_t hi = val / 10000UL;
+    k = Format4Digits(dst, hi, false);
+    val -= hi * 10000UL;
+  }
+  else {
+    byte top = val / 100000000UL; //max 42
+    val -= top * 100000000UL;
+    k = Format4Digits(dst, top, false);
+    uint16_t hi = val / 10000UL;
+    k += Format4Digits(dst + k, hi, true);
+    val -= hi * 10000UL;
+  }
+  return k + Format4Digits(dst + k, val, true);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+byte cSerialWatcher::FormatUnsigned(char *dst, uint64_t val) {
+  if ((val >> 32) == 0) {
+    return FormatUnsigned(dst, (uint32_t)val); //32 bit math is much faster on 8 bit boards
+  }
+  uint64_t top = val / 100000000ULL;
+  uint32_t low = val - top * 100000000ULL; //last 8 digits
+  byte k;
+  if ((top >> 32) == 0 && (uint32_t)top < 100000000UL) {
+    k = FormatUnsigned(dst, (uint32_t)top);
+  }
+  else {
+    uint16_t head = top / 100000000ULL; //max 1844
+    k = Format4Digits(dst, head, false);
+    k += Format8Digits(dst + k, top - head * 100000000ULL);
+  }
+  return k + Format8Digits(dst + k, low);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//val 0...99999999, always 8 digits (leading zeros)
+byte cSerialWatcher::Format8Digits(char *dst, uint32_t val) {
+  uint16_t hi = val / 10000UL;
+  Format4Digits(dst, hi, true);
+  Format4Digits(dst + 4, val - hi * 10000UL, true);
+  return 8;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//val 0...9999, pad=true always 4 digits (leading zeros), pad=false without leading zeros
+byte cSerialWatcher::Format4Digits(char *dst, uint16_t val, bool pad) {
+  byte hi = ((uint32_t)val * 5243UL) >> 19; //val / 100 without division, exact up to 43698
+  byte lo = val - hi * 100;
+  if (pad || hi >= 10) {
+    Format2Digits(dst, hi);
+    Format2Digits(dst + 2, lo);
+    return 4;
+  }
+  if (hi > 0) {
+    dst[0] = '0' + hi;
+    Format2Digits(dst + 1, lo);
+    return 3;
+  }
+  if (lo >= 10) {
+    Format2Digits(dst, lo);
+    return 2;
+  }
+  dst[0] = '0' + lo;
+  return 1;
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//val 0...99, always 2 digits
+void cSerialWatcher::Format2Digits(char *dst, byte val) {
+  dst[0] = pgm_read_byte(&DigitPairs[val * 2]);
+  dst[1] = pgm_read_byte(&DigitPairs[val * 2 + 1]);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+byte cSerialWatcher::FormatSigned(char *dst, int32_t val) {
+  if (val < 0) {
+    dst[0] = '-';
+    return 1 + FormatUnsigned(dst + 1, (uint32_t)0 - (uint32_t)val);
+  }
+  return FormatUnsigned(dst, (uint32_t)val);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+byte cSerialWatcher::FormatSigned(char *dst, int64_t val) {
+  if (val < 0) {
+    dst[0] = '-';
+    return 1 + FormatUnsigned(dst + 1, (uint64_t)0 - (uint64_t)val);
+  }
+  return FormatUnsigned(dst, (uint64_t)val);
+}
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+//two decimals, same rounding and special values of Print::printFloat()
+byte cSerialWatcher::FormatFloat(char *dst, float val) {
+  double number = val;
+  byte k = 0;
+  if (isnan(number)) {
+    strcpy_P(dst, PSTR("nan"));
+    return 3;
+  }
+  if (isinf(number)) {
+    strcpy_P(dst, PSTR("inf"));
+    return 3;
+  }
+  if (number > 4294967040.0 || number < -4294967040.0) {
+    strcpy_P(dst, PSTR("ovf"));
+    return 3;
+  }
+  if (number < 0.0) {
+    dst[k++] = '-';
+    number = -number;
+  }
+  number += 0.005; //rounding to two decimals
+  uint32_t int_part = (uint32_t)number;
+  double remainder = number - (double)int_part;
+  k += FormatUnsigned(dst + k, int_part);
+  dst[k++] = '.';
+  for (byte d = 0; d < 2; d++) {
+    remainder *= 10.0;
+    byte digit = (byte)remainder;
+    dst[k++] = '0' + digit;
+    remainder -= digit;
+  }
+  return k;
 }
 //-------------------------------------------------------------------------------------------------------------------------------------------------------------
-#endif
\ No newline at end of file
@@ -36,6 +36,48 @@
   > the following instuction add custome texts
       SerialWatcher.Text(F("My custom text"));
 
+  > the following instuction switch the stream to the compact binary records (SERIALWATCHER_TX_BINARY must be true)
+      SerialWatcher.TxMode(SERIALWATCHER_TX_MODE_BINARY);
+      SerialWatcher.TxMode(SERIALWATCHER_TX_MODE_BINARY | SERIALWATCHER_TX_MODE_COMPACT);  // varint integers and packed arrays (SERIALWATCHER_TX_COMPACT must be true)
+
+  > the following instuction send a float with 2 bytes in the binary mode (SERIALWATCHER_TX_FLOATENC must be true), half precision or fixed point
+      SerialWatcher.FloatEncoding(SERIALWATCHER_FLOAT_HALF);  // right after SerialWatcher.Map(F("Name"), float_var);
+      SerialWatcher.FloatEncoding(SERIALWATCHER_FLOAT_FIXED, 0.01, 20);  // value = 20 + integer * 0.01
+
+  > the following instuction map a whole numeric array as one slot (SERIALWATCHER_TX_NUMARRAYS must be true), the pc writes one value or a range with <i"3"4:10,11>
+      SerialWatcher.Map(F("adc"), adc);  // int16_t adc[16];
+
+  > with SERIALWATCHER_PROFILE true the library appends its own read only slots (sw.tx_us, sw.loop, sw.fps, sw.free ...) at the first Update()
+
+  > with SERIALWATCHER_TX_SNAPSHOT true all the numeric values of a stream are copied together at the stream start (same loop, not torn by the interrupts)
+
+  > with SERIALWATCHER_RX_BATCH true the pc can write more variables together, for example <f"0"1.5|f"1"0.2|f"2"0.01> (applied at the next Update(), all or nothing)
+
+  > the following instuction send only the changed values (SERIALWATCHER_TX_DELTA must be true), deadband is optional for floats
+      SerialWatcher.TxMode(SERIALWATCHER_TX_MODE_DELTA);
+      SerialWatcher.Deadband(0.1);  // right after SerialWatcher.Map(F("Name"), float_var);
+
+  > the following instuction send a variable every 8 streams (SERIALWATCHER_TX_REFRESH must be true), or only when it changes with SERIALWATCHER_REFRESH_ONCHANGE
+      SerialWatcher.Refresh(8);  // right after SerialWatcher.Map(F("Name"), var);
+
+  > the following instuction send names and features only in a schema frame, then values only (SERIALWATCHER_TX_SCHEMA must be true)
+      SerialWatcher.TxMode(SERIALWATCHER_TX_MODE_SCHEMA);
+
+  > the scope mode (SERIALWATCHER_SCOPE must be true) is started by the pc, for example <o"1"3,4> samples the slots 3 and 4 at every loop
+
+  > the following instuction send only the page 1 of the table, 32 slots for each page (also selectable by the pc with <g"32"1>)
+      SerialWatcher.TxPage(32, 1);
+
+  > with SERIALWATCHER_TX_SUBSCRIBE true the pc sends the slots it displays, for example <k"0"0-15,40>, and the streams skip the other ones
+      SerialWatcher.TxSubscribe(16, 39, false);  // the sketch can do the same: slots 16 ... 39 not sent
+
+  > the following instuction watch the last mapped variable (SERIALWATCHER_TX_ALARM must be true), an alarm is sent ahead of the stream when it goes above 80
+      SerialWatcher.Alarm(SERIALWATCHER_ALARM_ABOVE, 80);  // right after SerialWatcher.Map(F("Temperature"), temperature);
+      SerialWatcher.Alarm(SERIALWATCHER_ALARM_CHANGE);     // right after SerialWatcher.Map(F("Fault"), fault);
+
+  > the following instuction send more elements in each loop, as many as fit in a budget of microseconds and/or bytes
+      SerialWatcher.TxBudget(200, 0);
+
   > SerialWatcher class memory occupation can be reduced/exdended based on your needs! 
 	  Just increase/decrease the number of monitorning slots based how many variables to be monitored
       #define SERIALWATCHER_TX_MAX_VALUES 5
@@ -69,23 +111,243 @@
 #ifndef cSerialWatcher_h
 #define cSerialWatcher_h
 
+#include "Arduino.h" //Stream, byte, __FlashStringHelper (on a host build the same names are provided by a stub Arduino.h)
+#include <float.h> //FLT_MAX
+
 //Library configuration (base): max number of transmittable types
 #ifndef SERIALWATCHER_TX_MAX_VALUES
-  #define SERIALWATCHER_TX_MAX_VALUES 5  // array 0 .. TX_MAX_VALUES - 1
+  #define SERIALWATCHER_TX_MAX_VALUES 5  // array 0 .. TX_MAX_VALUES - 1 (more than 255 = 16 bit slot numbers, for the boards with more RAM)
+#endif
+#if SERIALWATCHER_TX_MAX_VALUES > 65535
+  #error "SERIALWATCHER_TX_MAX_VALUES must be up to 65535"
+#endif
+
+//Library configuration (base): the slot arrays are allocated while the variables are mapped, in blocks of SERIALWATCHER_TX_DYNAMIC_BLOCK slots,
+//so the RAM grows with the mapped variables and SERIALWATCHER_TX_MAX_VALUES is only the upper limit (meant for big tables on boards with a heap to spare)
+#ifndef SERIALWATCHER_TX_DYNAMIC
+  #define SERIALWATCHER_TX_DYNAMIC false
+#endif
+#ifndef SERIALWATCHER_TX_DYNAMIC_BLOCK
+  #define SERIALWATCHER_TX_DYNAMIC_BLOCK 16
 #endif
 
 //Library configuration (base): activate advanced diagnostics - pay attention this will add a long delay during the library Rx phase
 #define SERIALWATCHER_RX_ADV_DIAGNOSTICS false //"true" show rx advanced diagnostics -> leave to "false" before to release the project
 
+//Library configuration (base): enable the compact binary tx protocol, selectable at runtime through TxMode() or by the pc-app
+#ifndef SERIALWATCHER_TX_BINARY
+  #define SERIALWATCHER_TX_BINARY false
+#endif
+
+//Library configuration (base): enable the compact values of the binary stream, selectable at runtime through TxMode() or by the pc-app (requires SERIALWATCHER_TX_BINARY)
+//the integers are sent as LEB128 varints (zigzag for the signed ones) and the values of the numeric arrays as PackBits runs of equal bytes
+#ifndef SERIALWATCHER_TX_COMPACT
+  #define SERIALWATCHER_TX_COMPACT false
+#endif
+#if SERIALWATCHER_TX_COMPACT && !SERIALWATCHER_TX_BINARY
+  #error "SERIALWATCHER_TX_COMPACT requires SERIALWATCHER_TX_BINARY"
+#endif
+
+//Library configuration (base): enable the float encodings of the binary stream, chosen for each float with FloatEncoding() right after its map
+//half precision or fixed point (value = offset + integer * scale, the pc applies scale and offset): 2 bytes instead of 4 (requires SERIALWATCHER_TX_BINARY)
+#ifndef SERIALWATCHER_TX_FLOATENC
+  #define SERIALWATCHER_TX_FLOATENC false
+#endif
+#ifndef SERIALWATCHER_TX_FLOATENC_MAX
+  #define SERIALWATCHER_TX_FLOATENC_MAX 4 //max number of floats with an encoding
+#endif
+#if SERIALWATCHER_TX_FLOATENC && !SERIALWATCHER_TX_BINARY
+  #error "SERIALWATCHER_TX_FLOATENC requires SERIALWATCHER_TX_BINARY"
+#endif
+
+//Library configuration (base): enable the change-only (delta) streaming, selectable at runtime through TxMode() or by the pc-app
+#ifndef SERIALWATCHER_TX_DELTA
+  #define SERIALWATCHER_TX_DELTA false
+#endif
+
+//Library configuration (base): enable the schema session (names and features sent once in a schema frame, then values only), selectable at runtime through TxMode() or by the pc-app
+#ifndef SERIALWATCHER_TX_SCHEMA
+  #define SERIALWATCHER_TX_SCHEMA false
+#endif
+
+//Library configuration (base): enable the refresh classes, each slot can be sent at every stream, every n streams or only when it changes (requires SERIALWATCHER_TX_DELTA)
+//the streams that skip some slots are sent as delta streams, one stream every SERIALWATCHER_TX_DELTA_KEYFRAME is a full keyframe
+#ifndef SERIALWATCHER_TX_REFRESH
+  #define SERIALWATCHER_TX_REFRESH false
+#endif
+#if SERIALWATCHER_TX_REFRESH && !SERIALWATCHER_TX_DELTA
+  #error "SERIALWATCHER_TX_REFRESH requires SERIALWATCHER_TX_DELTA"
+#endif
+
+//Library configuration (base): enable the numeric arrays, an array of bool, integers or float is mapped as one slot with Map(F("Name"), array)
+//its values are sent as one element (ascii: comma separated, binary: packed records) and the pc can write one value or a range of values
+#ifndef SERIALWATCHER_TX_NUMARRAYS
+  #define SERIALWATCHER_TX_NUMARRAYS false
+#endif
+#ifndef SERIALWATCHER_TX_NUMARRAYS_MAX
+  #define SERIALWATCHER_TX_NUMARRAYS_MAX 4 //max number of mapped numeric arrays
+#endif
+
+//Library configuration (base): enable the batched writes, the pc sends more writes in one command <i"3"10|f"4"0.5|...> that are applied together
+//at the start of the next Update() (all or nothing), with a single acknowledge !batch"result"writes; right after the next stream start
+#ifndef SERIALWATCHER_RX_BATCH
+  #define SERIALWATCHER_RX_BATCH false
+#endif
+#ifndef SERIALWATCHER_RX_BATCH_MAX
+  #define SERIALWATCHER_RX_BATCH_MAX 4 //max number of writes in a batch (8 bytes each)
+#endif
+
+//Library configuration (base): enable the snapshot of the values, at each stream start the numeric values are copied together (interrupts disabled)
+//into a buffer of SERIALWATCHER_TX_SNAPSHOT_BUFFER bytes and the stream is encoded from it, so all the values of a stream belong to the same loop
+//the values that don't fit in the buffer, the chars and the texts are read when sent
+#ifndef SERIALWATCHER_TX_SNAPSHOT
+  #define SERIALWATCHER_TX_SNAPSHOT false
+#endif
+#ifndef SERIALWATCHER_TX_SNAPSHOT_BUFFER
+  #define SERIALWATCHER_TX_SNAPSHOT_BUFFER 64 //bytes (each value is aligned to its size)
+#endif
+
+//Library configuration (base): enable the scope mode, the pc selects up to SERIALWATCHER_SCOPE_SLOTS numeric slots that are sampled every loop (or every n loops)
+//into a ring buffer of SERIALWATCHER_SCOPE_BUFFER bytes, sent as binary bursts between the streams (requires SERIALWATCHER_TX_BINARY and the binary tx mode)
+#ifndef SERIALWATCHER_SCOPE
+  #define SERIALWATCHER_SCOPE false
+#endif
+#ifndef SERIALWATCHER_SCOPE_SLOTS
+  #define SERIALWATCHER_SCOPE_SLOTS 4 //max number of sampled slots
+#endif
+#ifndef SERIALWATCHER_SCOPE_BUFFER
+  #define SERIALWATCHER_SCOPE_BUFFER 128 //bytes of the ring buffer (128 bytes = 64 samples of one int16_t)
+#endif
+#if SERIALWATCHER_SCOPE && !SERIALWATCHER_TX_BINARY
+  #error "SERIALWATCHER_SCOPE requires SERIALWATCHER_TX_BINARY"
+#endif
+
+//Library configuration (base): enable the subscription, the pc sends the slots it displays (<k"0"0-15,40> or a bitmap <K"0"FFFF>) and the streams skip
+//the other ones (the schema frames excepted), one bit for each slot, the slots are subscribed when mapped
+#ifndef SERIALWATCHER_TX_SUBSCRIBE
+  #define SERIALWATCHER_TX_SUBSCRIBE false
+#endif
+
+//Library configuration (base): enable the alarms, a watch condition of a numeric variable (above or below a limit, bits of a mask, any change) chosen with Alarm()
+//right after its map and checked at every Update(), a short alarm element is sent at the next element boundary ahead of the sweep (one alarm for each boundary,
+//a change alarm once for each stream, a waiting stream still starts after SERIALWATCHER_TX_STREAM_PERIOD)
+#ifndef SERIALWATCHER_TX_ALARM
+  #define SERIALWATCHER_TX_ALARM false
+#endif
+#ifndef SERIALWATCHER_TX_ALARM_MAX
+  #define SERIALWATCHER_TX_ALARM_MAX 4 //max number of watched variables (up to 8)
+#endif
+#if SERIALWATCHER_TX_ALARM_MAX > 8
+  #error "SERIALWATCHER_TX_ALARM_MAX must be up to 8"
+#endif
+
+//Library configuration (base): enable the self profiling, read only slots appended to the table at the first Update(): Tx()/Rx() time, max Update() time,
+//histogram of the loop period, bytes sent and received, streams per second, rx errors and overflows, free ram (requires SERIALWATCHER_TX_NUMARRAYS)
+#ifndef SERIALWATCHER_PROFILE
+  #define SERIALWATCHER_PROFILE false
+#endif
+#ifndef SERIALWATCHER_PROFILE_BUCKETS
+  #define SERIALWATCHER_PROFILE_BUCKETS 8 //loop period buckets: < 128 us, < 512 us, < 2 ms ... (x4 each), the last one takes the longer periods
+#endif
+#if SERIALWATCHER_PROFILE && !SERIALWATCHER_TX_NUMARRAYS
+  #error "SERIALWATCHER_PROFILE requires SERIALWATCHER_TX_NUMARRAYS"
+#endif
+#define SERIALWATCHER_PROFILE_SLOTS 10 //read only slots appended by the profiling, see ProfileMap()
+#if SERIALWATCHER_PROFILE && SERIALWATCHER_TX_MAX_VALUES <= SERIALWATCHER_PROFILE_SLOTS
+  #error "SERIALWATCHER_PROFILE requires SERIALWATCHER_TX_MAX_VALUES > SERIALWATCHER_PROFILE_SLOTS (plus the mapped variables)"
+#endif
+#define SERIALWATCHER_NUMARRAYS_TABLE (SERIALWATCHER_TX_NUMARRAYS_MAX + (SERIALWATCHER_PROFILE ? 1 : 0)) //the mapped arrays plus the loop histogram (sw.loop)
+
+//Library configuration (base): tx budget of each Update(), as many elements as fit are sent (both 0 = one element for each Update()), can be changed at runtime through TxBudget()
+#ifndef SERIALWATCHER_TX_BUDGET_US
+  #define SERIALWATCHER_TX_BUDGET_US 0 //microseconds
+#endif
+#ifndef SERIALWATCHER_TX_BUDGET_BYTES
+  #define SERIALWATCHER_TX_BUDGET_BYTES 0 //bytes
+#endif
+
+//Library configuration (base): minimum time between two stream starts to allow pc-app decode data
+#ifndef SERIALWATCHER_TX_STREAM_PERIOD
+  #define SERIALWATCHER_TX_STREAM_PERIOD 25 //milliseconds
+#endif
+
 //Library configuration (advanced)
 #define SERIALWATCHER_RX_ARRAY_LENGTH 26 //lenght of array containing rx data = MAX_EDIT_ACHAR + '<' + 'b' + ':' + '1' + '2' + ':' + '>' + '\0'
+#define SERIALWATCHER_RX_MAX_READ 64 //max number of chars read from the serial port at each Update()
+#define SERIALWATCHER_TX_ARRAY_LENGTH 48 //lenght of array containing tx data waiting to be sent = one ascii element (or part of it) or one binary record (max 255)
+#if SERIALWATCHER_TX_ARRAY_LENGTH > 255 || SERIALWATCHER_TX_ARRAY_LENGTH < 32
+  #error "SERIALWATCHER_TX_ARRAY_LENGTH must be between 32 and 255"
+#endif
+#define SERIALWATCHER_TX_DELTA_KEYFRAME 20 //in delta mode one stream every SERIALWATCHER_TX_DELTA_KEYFRAME is a full keyframe (to resync a pc-app connected later)
+#define SERIALWATCHER_TX_DELTA_DEADBANDS 4 //max number of float variables with a deadband
 
 // Tx codes
 #define SERIALWATCHER_TX_CODE_STREAM_START "<*" // identifies the transmission stream Start
+#define SERIALWATCHER_TX_CODE_STREAM_START_DELTA "<+" // identifies the transmission stream Start of a delta stream (only the changed values)
+#define SERIALWATCHER_TX_CODE_SCHEMA_START "<#" // schema session: identifies the start of a schema frame <#version; slot"name"features; ... *>
+#define SERIALWATCHER_TX_CODE_VALUES_START "<=" // schema session: identifies the start of a value frame <=version; slot"value; ... *> (slot; = invalid value)
+#define SERIALWATCHER_TX_CODE_VALUES_START_DELTA "<~" // schema session: identifies the start of a delta value frame (only the changed values)
 #define SERIALWATCHER_TX_CODE_STREAM_END "*>" // identifies the transmission stream End
 #define SERIALWATCHER_TX_CODE_EXCEEDED_MAX_TXVAR "*1*" //exceeded max number of transmittable data (error)
+#define SERIALWATCHER_TX_CODE_PAGE "@" // paged stream: page of the table, sent right after the stream start @page"pages;
+#define SERIALWATCHER_TX_CODE_ACK "!" // batched writes: acknowledge, sent right after the stream start !batch"result"writes; (batch = counter of the received batches)
+#define SERIALWATCHER_TX_CODE_ALARM "^" // alarm of a watched variable, ahead of the sweep ^slot"state"value"features; (state 1 = raised or changed, 0 = cleared)
 #define SERIALWATCHER_TX_FIELD_SEPARATOR "\""  // identifies the transmission of a field separator -> this cannot be used for the map function
 #define SERIALWATCHER_TX_ELEMENT_SEPARATOR ";"  // identifies the transmission of a code separator (new data) -> this cannot be used for the map function
+#define SERIALWATCHER_TX_VALUE_SEPARATOR ","  // separates the values of a numeric array
+
+// Tx modes
+#define SERIALWATCHER_TX_MODE_ASCII 0x00  // human readable stream <* ... *> (default, used by SerialWatcherApp)
+#define SERIALWATCHER_TX_MODE_BINARY 0x01 // compact binary records (requires SERIALWATCHER_TX_BINARY)
+#define SERIALWATCHER_TX_MODE_DELTA 0x02  // send only the changed values, plus a full keyframe periodically (requires SERIALWATCHER_TX_DELTA)
+#define SERIALWATCHER_TX_MODE_SCHEMA 0x04 // send names and features in a schema frame only when needed, then value frames (requires SERIALWATCHER_TX_SCHEMA)
+#define SERIALWATCHER_TX_MODE_COMPACT 0x08 // binary mode: integers as varints and packed numeric arrays (requires SERIALWATCHER_TX_COMPACT)
+
+// Refresh classes (see Refresh())
+#define SERIALWATCHER_REFRESH_ONCHANGE 0 // the slot is sent only when it changes (and in the keyframes)
+#define SERIALWATCHER_REFRESH_ALWAYS 1   // the slot is sent at every stream (default), 2, 4, 8 ... 128 = the slot is sent every n streams
+
+// Float encodings of the binary stream (see FloatEncoding())
+#define SERIALWATCHER_FLOAT_RAW 0   // IEEE-754 single precision, 4 bytes (default)
+#define SERIALWATCHER_FLOAT_HALF 1  // IEEE-754 half precision, 2 bytes (3 significant digits, up to 65504), sent as SERIALWATCHER_DATATYPE_half
+#define SERIALWATCHER_FLOAT_FIXED 2 // fixed point int16_t, value = offset + integer * scale (clamped to -32768 ... 32767), sent as SERIALWATCHER_DATATYPE_fixed16
+
+// Alarm conditions (see Alarm())
+#define SERIALWATCHER_ALARM_ABOVE 0  // raised when the value goes above the limit, cleared when it is back to the limit or below
+#define SERIALWATCHER_ALARM_BELOW 1  // raised when the value goes below the limit, cleared when it is back to the limit or above
+#define SERIALWATCHER_ALARM_MASK 2   // raised when one of the bits of the mask (limit) is set, cleared when they are all clear (the lowest 32 bits)
+#define SERIALWATCHER_ALARM_CHANGE 3 // sent at a change of the value, for example a bool fault flag (once for each stream, then the latest value)
+
+// Subscription commands (ArrayPlace of <k"op"slots>, see SERIALWATCHER_TX_SUBSCRIBE)
+#define SERIALWATCHER_SUBSCRIBE_REPLACE 0 // only the listed slots are sent
+#define SERIALWATCHER_SUBSCRIBE_ADD 1     // the listed slots are sent too
+#define SERIALWATCHER_SUBSCRIBE_REMOVE 2  // the listed slots are no more sent
+
+// Tx binary records
+// each record is | type | length | payload (length bytes) | checksum |, checksum makes the 8 bit sum of the whole record equal to zero
+// the record is then COBS encoded (no zero bytes inside) and terminated by SERIALWATCHER_TX_BIN_DELIMITER
+// multi-byte values are little-endian
+#define SERIALWATCHER_TX_BIN_DELIMITER 0x00
+#define SERIALWATCHER_TX_BIN_RECORD_STREAM_START 0x01 // same as SERIALWATCHER_TX_CODE_STREAM_START, payload: | flags |
+#define SERIALWATCHER_TX_BIN_RECORD_STREAM_END 0x02   // same as SERIALWATCHER_TX_CODE_STREAM_END, payload: | flags |
+#define SERIALWATCHER_TX_BIN_RECORD_ELEMENT 0x03      // payload: | slot | features | value length | value | name |
+#define SERIALWATCHER_TX_BIN_RECORD_SCHEMA_ELEMENT 0x04 // schema frame element, payload: | slot | features | name |
+#define SERIALWATCHER_TX_BIN_RECORD_VALUE 0x05        // value frame element, payload: | slot | value | (no value = invalid value or empty text)
+#define SERIALWATCHER_TX_BIN_RECORD_SCOPE 0x06        // scope burst, payload: | sequence (2 bytes) | lost (2 bytes) | samples ... |
+                                                      // sequence = number of the first sample of the burst, lost = samples dropped because the ring buffer was full (both wrap at 65536)
+                                                      // each sample = raw values of the sampled slots, in the order of the scope command
+#define SERIALWATCHER_TX_BIN_RECORD_PAGE 0x07         // paged stream, sent right after the stream start, payload: | page (2 bytes) | pages (2 bytes) |
+#define SERIALWATCHER_TX_BIN_RECORD_ARRAY 0x08        // values of a numeric array, after its element record (no value), payload: | slot | first index (2 bytes) | values ... |
+                                                      // the values of a long array are split in more records
+#define SERIALWATCHER_TX_BIN_RECORD_ACK 0x09          // batched writes, sent right after the stream start, payload: | batch | result | writes |
+#define SERIALWATCHER_TX_BIN_RECORD_ALARM 0x0A        // alarm of a watched variable, ahead of the sweep, payload: | slot | state | features | value (raw) |
+#define SERIALWATCHER_TX_BIN_FLAG_EXCEEDED_MAX_TXVAR 0x01 // stream end flags: same as SERIALWATCHER_TX_CODE_EXCEEDED_MAX_TXVAR
+#define SERIALWATCHER_TX_BIN_FLAG_DELTA 0x02 // stream start flags: same as SERIALWATCHER_TX_CODE_STREAM_START_DELTA
+#define SERIALWATCHER_TX_BIN_FLAG_SCHEMA 0x04 // stream start flags: schema frame, the payload continues with | schema version |
+#define SERIALWATCHER_TX_BIN_FLAG_VALUES 0x08 // stream start flags: value frame, the payload continues with | schema version |
+#define SERIALWATCHER_TX_BIN_FLAG_WIDE 0x10   // stream start flags: the slot numbers of the element records are 2 bytes (SERIALWATCHER_TX_MAX_VALUES > 255)
+#define SERIALWATCHER_TX_BIN_FLAG_COMPACT 0x20 // stream start flags: the integer values are LEB128 varints (zigzag for the signed datatypes),
+                                               // the values of the array records are PackBits runs (n = 0 ... 127: n+1 bytes follow, n = -1 ... -127: the next byte 1-n times)
 
 // Tx Datatypes encoding
 #define SERIALWATCHER_DATATYPE_bool 0
@@ -101,8 +363,8 @@
 #define SERIALWATCHER_DATATYPE_char 10
 #define SERIALWATCHER_DATATYPE_achar 11
 #define SERIALWATCHER_DATATYPE_flashstring 12
-#define SERIALWATCHER_DATATYPE_FREE0 13 //free (spare - available for future implementations)
-#define SERIALWATCHER_DATATYPE_FREE1 14 //free (spare - available for future implementations)
+#define SERIALWATCHER_DATATYPE_half 13 //binary stream only: float in IEEE-754 half precision (2 bytes)
+#define SERIALWATCHER_DATATYPE_fixed16 14 //binary stream only: float as int16_t fixed point, the element and schema element records carry | scale | offset | (2 floats) before the name
 #define SERIALWATCHER_DATATYPE_FREE2 15 //free (spare - available for future implementations)
 
 // Tx Array Features - BitMask
@@ -110,13 +372,13 @@
 #define SERIALWATCHER_FEATURES_MASK_INVALID_NAME 0x10 // Var Features encoded: b4 tells if the field has an invalid name (0=ok, | 1=invalid)
 #define SERIALWATCHER_FEATURES_MASK_INVALID_VALUE 0x20 // Var Features encoded: b5 tells if the field has an invalid value (0=ok, | 1=invalid)
 #define SERIALWATCHER_FEATURES_MASK_READONLY 0x40 // Var Features encoded: b6 tells if the field is readonly (0=read/write | 1=readonly)
-#define SERIALWATCHER_FEATURES_MASK_FREE 0x80 // Var Features encoded: b7 is free (spare - available for future implementations)
+#define SERIALWATCHER_FEATURES_MASK_ARRAY 0x80 // Var Features encoded: b7 tells if the field is a numeric array (0=single value | 1=array)
 
 // Rx codes
-#define SERIALWATCHER_RX_BUFFER_END_IDX ';'    // identifies the rx data buffer array index (position of the last character)
 #define SERIALWATCHER_RX_CODE_STREAM_START '<' // identifies the receipt of the stream Start (max one character)
 #define SERIALWATCHER_RX_CODE_STREAM_END '>'   // identifies the receipt of the stream End (max one character)
 #define SERIALWATCHER_RX_FIELD_SEPARATOR '"'   // identifies the receipt of the stream field separator (max one character)
+#define SERIALWATCHER_RX_BATCH_SEPARATOR '|'   // separates the writes of a batch, for example <i"3"10|f"4"0.5> (max one character)
 #define SERIALWATCHER_RX_CODE_STREAM_bool 'b'   // (max one character)
 #define SERIALWATCHER_RX_CODE_STREAM_int8_t 'q' // (max one character)
 #define SERIALWATCHER_RX_CODE_STREAM_uint8_t 'd'  // (max one character)
@@ -129,9 +391,81 @@
 #define SERIALWATCHER_RX_CODE_STREAM_float 'f' // " (max one character)
 #define SERIALWATCHER_RX_CODE_STREAM_char 'c'  // " (max one character)
 #define SERIALWATCHER_RX_CODE_STREAM_achar 's' // " (max one character)
+#define SERIALWATCHER_RX_CODE_STREAM_txmode 'p' // select the tx mode, for example <p"0"1> (max one character)
+#define SERIALWATCHER_RX_CODE_STREAM_schema 'h' // schema session: send a schema frame at the next stream start, for example <h"0"0> (max one character)
+#define SERIALWATCHER_RX_CODE_STREAM_scope 'o'  // scope mode (binary tx mode only): ArrayPlace = decimation (0 = stop), Value = sampled slots, for example <o"1"3,4> (max one character)
+#define SERIALWATCHER_RX_CODE_STREAM_page 'g'   // paged streams: ArrayPlace = slots for each page (0 = whole table), Value = page, for example <g"32"1> (max one character)
+#define SERIALWATCHER_RX_CODE_STREAM_subscribe 'k' // subscription: ArrayPlace = SERIALWATCHER_SUBSCRIBE_*, Value = slots and ranges (* = all), for example <k"0"0-15,40> (max one character)
+#define SERIALWATCHER_RX_CODE_STREAM_subscribemap 'K' // subscription bitmap: ArrayPlace = first slot (multiple of 8), Value = hex bytes (bit 0 = first slot), for example <K"8"FF0F> (max one character)
+
+// Rx errors (result of the last rx command, see RxError())
+#define SERIALWATCHER_RX_OK 0
+#define SERIALWATCHER_RX_ERROR_FORMAT 1   // missing or malformed fields
+#define SERIALWATCHER_RX_ERROR_COMMAND 2  // unknown DataType code, or a command not available in the selected tx mode
+#define SERIALWATCHER_RX_ERROR_SLOT 3     // ArrayPlace is not a mapped slot
+#define SERIALWATCHER_RX_ERROR_DATATYPE 4 // DataType is not the one of the mapped variable
+#define SERIALWATCHER_RX_ERROR_READONLY 5 // the mapped variable is readonly
+#define SERIALWATCHER_RX_ERROR_VALUE 6    // Value is not a valid number or it is out of the datatype range
+#define SERIALWATCHER_RX_ERROR_OVERFLOW 7 // Value longer than the rx buffer, or a text longer than the mapped array of chars
+#define SERIALWATCHER_RX_ERROR_INDEX 8    // numeric array: the Value index:value,value ... is missing the index or it goes beyond the array
+#define SERIALWATCHER_RX_ERROR_BATCH 9    // more than SERIALWATCHER_RX_BATCH_MAX writes in a batch
  
-#define SERIALWATCHER_MEMO_FISTMAPDONE         B00000001 //when TRUE means that first map has been done
-#define SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR  B00000010 //when TRUE means that the maximum number of transmittable variables has been exceeded
+#define SERIALWATCHER_MEMO_FISTMAPDONE         0x01 //when TRUE means that first map has been done
+#define SERIALWATCHER_MEMO_EXCEEDED_MAX_TXVAR  0x02 //when TRUE means that the maximum number of transmittable variables has been exceeded
+#define SERIALWATCHER_MEMO_TX_DELTA_STREAM     0x04 //when TRUE means that the stream in progress is a delta stream (only the changed values)
+#define SERIALWATCHER_MEMO_TX_AFW              0x08 //when TRUE means that the serial port implements availableForWrite() (non blocking tx)
+#define SERIALWATCHER_MEMO_RX_STREAM           0x10 //when TRUE means that a rx stream is in progress (start received)
+#define SERIALWATCHER_MEMO_TX_SCHEMA_FRAME     0x20 //when TRUE means that the stream in progress is a schema frame
+#define SERIALWATCHER_MEMO_TX_SCHEMA_REQUEST   0x40 //when TRUE means that a schema frame has to be sent at the next stream start
+#define SERIALWATCHER_MEMO_TX_REFRESH          0x80 //when TRUE means that at least one slot has a refresh class (the streams can skip slots)
+
+// Batched writes states
+#define SERIALWATCHER_RX_BATCH_IDLE 0   // nothing to do
+#define SERIALWATCHER_RX_BATCH_COMMIT 1 // staged writes to be applied at the start of the next Update()
+#define SERIALWATCHER_RX_BATCH_ACK 2    // acknowledge to be sent at the next stream start
+
+// Tx states (the slot in progress is kept apart, see TxStep())
+#define SERIALWATCHER_TX_STATE_START 0
+#define SERIALWATCHER_TX_STATE_PAGE 1
+#define SERIALWATCHER_TX_STATE_ELEMENTS 2
+#define SERIALWATCHER_TX_STATE_END 3
+#define SERIALWATCHER_TX_STATE_WAIT 4
+
+// Slot number, 16 bit only when the table can be bigger than 255 slots
+#if SERIALWATCHER_TX_MAX_VALUES > 255
+typedef uint16_t cSerialWatcherIndex;
+#else
+typedef byte cSerialWatcherIndex;
+#endif
+
+// Slot arrays: fixed size, or allocated while the variables are mapped (see SERIALWATCHER_TX_DYNAMIC)
+#if SERIALWATCHER_TX_DYNAMIC
+  #define SERIALWATCHER_SLOT_ARRAY(name) *name
+#else
+  #define SERIALWATCHER_SLOT_ARRAY(name) name[SERIALWATCHER_TX_MAX_VALUES]
+#endif
+
+// Value codec of a mapped variable: text of the value (tx) and write of the value from a text (rx)
+struct cSerialWatcherCodec {
+  byte (*Format)(char *dst, const void *value); //writes the value text without terminator, returns the number of chars (NULL = text datatype)
+  bool (*Parse)(const char *src, void *value);  //writes the value, true=valid (NULL = the value can't be written)
+};
+
+// Datatype traits of the mappable types, resolved at compile time (see the specializations at the end of this file)
+template <typename T> struct cSerialWatcherTraits;
+template <typename T, bool sign> struct cSerialWatcherIntTraits;
+
+// Slot of a registration table stored in flash, mapped once in the setup routine with Map(table, count)
+//   const char NameSpeed[] PROGMEM = "Speed";
+//   const cSerialWatcherSlot Slots[] PROGMEM = { SERIALWATCHER_SLOT(NameSpeed, speed, false), ... };
+struct cSerialWatcherSlot {
+  const char *name;                  //name stored in flash (PROGMEM)
+  void *value;                       //mapped variable
+  const cSerialWatcherCodec *codec;  //value codec
+  byte features;                     //datatype, SERIALWATCHER_FEATURES_MASK_READONLY
+};
+#define SERIALWATCHER_SLOT(name, variable, readonly) { name, &(variable), &cSerialWatcherTraits<decltype(variable)>::codec, \
+  (byte)(cSerialWatcherTraits<decltype(variable)>::datatype | ((readonly) ? SERIALWATCHER_FEATURES_MASK_READONLY : 0)) }
 
 class cSerialWatcher {
   
@@ -139,25 +473,53 @@ class cSerialWatcher {
   public:
     cSerialWatcher(Stream &serial); //constructor
     //& = pass by reference method, when call the function is not necessary to convert input to a pointer
-    void Map(const __FlashStringHelper *Name, bool &Value, bool readonly = false);
-    void Map(const __FlashStringHelper *Name, int8_t &Value, bool readonly = false);
-    void Map(const __FlashStringHelper *Name, uint8_t &Value, bool readonly = false);
-    void Map(const __FlashStringHelper *Name, int16_t &Value, bool readonly = false);
-    void Map(const __FlashStringHelper *Name, uint16_t &Value, bool readonly = false);
-    #if defined(ARDUINO_UNOR4_MINIMA) || defined(ARDUINO_UNOR4_WIFI)
-    void Map(const __FlashStringHelper *Name, int &Value, bool readonly = false); //special case to manage arduino R4 (int are 32bits)
-    #endif
-    void Map(const __FlashStringHelper *Name, int32_t &Value, bool readonly = false); 
-    void Map(const __FlashStringHelper *Name, uint32_t &Value, bool readonly = false);
-    void Map(const __FlashStringHelper *Name, int64_t &Value, bool readonly = false); 
-    void Map(const __FlashStringHelper *Name, uint64_t &Value, bool readonly = false);
-    void Map(const __FlashStringHelper *Name, float &Value, bool readonly = false);
-    void Map(const __FlashStringHelper *Name, char &Value, bool readonly = false);
-    void Map(const __FlashStringHelper *Name, char *Value, bool readonly = false);  //array of chars: char Value[]
+    //the variables are mapped once in the setup routine (or at every loop, old style)
+    //bool, integers of any width (int is mapped on its real size on every board), float and char: datatype and codec come from cSerialWatcherTraits<T>
+    template <typename T> void Map(const __FlashStringHelper *Name, T &Value, bool readonly = false) {
+      MapSlot(Name, &Value, cSerialWatcherTraits<T>::datatype, &cSerialWatcherTraits<T>::codec, readonly);
+    }
+    #if SERIALWATCHER_TX_NUMARRAYS
+    //numeric array: int16_t Value[N] (the arrays of chars are texts, see below)
+    template <typename T, size_t N> void Map(const __FlashStringHelper *Name, T (&Value)[N], bool readonly = false) {
+      MapSlot(Name, Value, cSerialWatcherTraits<T>::datatype, &cSerialWatcherTraits<T>::codec, readonly);
+      MapArray(N);
+    }
+    #endif
+    template <size_t N> void Map(const __FlashStringHelper *Name, char (&Value)[N], bool readonly = false) { //array of chars: char Value[N], the pc writes up to N-1 chars
+      Map(Name, (char*)Value, (size_t)N, readonly);
+    }
+    void Map(const __FlashStringHelper *Name, char *Value, size_t size, bool readonly = false); //array of chars by pointer: size of the buffer, terminator included
     void Map(const __FlashStringHelper *Name, const __FlashStringHelper *Value); //flashstring
+    void Map(const cSerialWatcherSlot *Table, uint16_t count); //registration table stored in flash (PROGMEM)
     void Text(const __FlashStringHelper *Value);   //write a fixed value
     void EmptySpace();
+    void TxMode(byte mode); //select SERIALWATCHER_TX_MODE_ASCII, SERIALWATCHER_TX_MODE_BINARY, SERIALWATCHER_TX_MODE_DELTA, SERIALWATCHER_TX_MODE_SCHEMA, SERIALWATCHER_TX_MODE_COMPACT (combinable), applied at the next stream start
+    void TxPage(uint16_t size, uint16_t page); //paged streams: send only the page of size slots (size 0 = whole table), applied at the next stream start
+    #if SERIALWATCHER_TX_SUBSCRIBE
+    void TxSubscribe(uint16_t first, uint16_t last, bool subscribed = true); //subscription: send (or skip) the slots first ... last, applied at the next stream start
+    #endif
+    void TxBudget(unsigned int us, unsigned int bytes = 0); //tx budget of each update in microseconds and/or bytes (0, 0 = one element for each update)
+    void Deadband(float band); //delta mode: the last mapped float is sent again only when it moves more than band
+    void Refresh(byte every); //refresh class of the last mapped variable: SERIALWATCHER_REFRESH_ONCHANGE, SERIALWATCHER_REFRESH_ALWAYS or every 2, 4 ... 128 streams
+    void Alarm(byte condition, float limit = 0); //watch condition of the last mapped variable: SERIALWATCHER_ALARM_ABOVE, SERIALWATCHER_ALARM_BELOW, SERIALWATCHER_ALARM_MASK (limit = mask) or SERIALWATCHER_ALARM_CHANGE
+    void Alarm(byte condition, double limit) {
+      Alarm(condition, (float)limit);
+    }
+    void Alarm(byte condition, unsigned long mask) { //an unsigned integer is also the whole 32 bit mask (a float keeps 24 bits)
+      AlarmWatch(condition, (float)mask, (uint32_t)mask);
+    }
+    void Alarm(byte condition, unsigned int mask) {
+      Alarm(condition, (unsigned long)mask);
+    }
+    void Alarm(byte condition, long limit) { //a signed integer keeps its sign as a limit and its bits as a mask
+      AlarmWatch(condition, (float)limit, (uint32_t)limit);
+    }
+    void Alarm(byte condition, int limit) {
+      Alarm(condition, (long)limit);
+    }
+    void FloatEncoding(byte encoding, float scale = 1, float offset = 0); //binary stream encoding of the last mapped float: SERIALWATCHER_FLOAT_RAW, SERIALWATCHER_FLOAT_HALF or SERIALWATCHER_FLOAT_FIXED
     void Update();
+    byte RxError(); //result of the last rx command: SERIALWATCHER_RX_OK or SERIALWATCHER_RX_ERROR_*
     
   // private attributes
   private:
@@ -168,51 +530,342 @@ class cSerialWatcher {
     //error memories
     byte _mem;
 
-    //global sequence index
-    byte indexglobal;
+    //number of mapped slots
+    cSerialWatcherIndex SlotCount;
+
+    //map cursor (old style Map() at every loop)
+    cSerialWatcherIndex indexglobal;
+
+    #if SERIALWATCHER_TX_DYNAMIC
+    //number of allocated slots
+    cSerialWatcherIndex SlotCapacity;
+    #endif
 
     //name, value and datatype of each pointed variable
-    const __FlashStringHelper *ArrayNames[SERIALWATCHER_TX_MAX_VALUES];
+    const __FlashStringHelper *SERIALWATCHER_SLOT_ARRAY(ArrayNames);
 
     //array of pointers to void
-    void *ArrayValues[SERIALWATCHER_TX_MAX_VALUES]; 
+    void *SERIALWATCHER_SLOT_ARRAY(ArrayValues); 
 
     // array of encoded features | **encoded
-    // b0 b1 b2 b3 b4 tells datatype
-    // b5 tells if the field has an invalid name (0=ok, | 1=invalid)
-    // b6 tells if the field has an invalid value (0=ok, | 1=invalid)
-    // b7 tells if the field is readonly (0=read/write | 1=readonly)
-    byte ArrayFeatures[SERIALWATCHER_TX_MAX_VALUES];
+    // b0 b1 b2 b3 tells datatype (SERIALWATCHER_FEATURES_MASK_DATATYPE)
+    // b4 tells if the field has an invalid name (0=ok, | 1=invalid)
+    // b5 tells if the field has an invalid value (0=ok, | 1=invalid)
+    // b6 tells if the field is readonly (0=read/write | 1=readonly)
+    // b7 tells if the field is a numeric array (0=single value | 1=array)
+    byte SERIALWATCHER_SLOT_ARRAY(ArrayFeatures);
+
+    //value codec of each pointed variable
+    const cSerialWatcherCodec *SERIALWATCHER_SLOT_ARRAY(ArrayCodecs);
+
+    //size of each mapped array of chars, terminator included (up to 255, the rx texts are shorter)
+    byte SERIALWATCHER_SLOT_ARRAY(ArrayTextSizes);
 
     //tx memories
-    byte TxIdx;
+    byte TxState; //SERIALWATCHER_TX_STATE_*
+    cSerialWatcherIndex TxSlot; //slot in progress
+    cSerialWatcherIndex TxSlotEnd; //end of the slots of the stream in progress (whole table or page)
+    uint16_t _page; //page selected by the pc
+    uint16_t _pagesize; //slots for each page (0 = whole table)
+    #if SERIALWATCHER_TX_SUBSCRIBE
+    #if SERIALWATCHER_TX_DYNAMIC
+    byte *ArraySubscribed; //one bit for each slot (slot 0 = bit 0 of the first byte), 1 = sent
+    #else
+    byte ArraySubscribed[(SERIALWATCHER_TX_MAX_VALUES + 7) / 8]; //one bit for each slot (slot 0 = bit 0 of the first byte), 1 = sent
+    #endif
+    #endif
+    byte _txmode; //active tx mode (latched at the stream start)
+    byte _txmoderequest; //requested tx mode
+    byte TxBuffer[SERIALWATCHER_TX_ARRAY_LENGTH]; //tx data waiting to be sent (ascii element or binary record)
+    byte TxLen; //number of bytes in TxBuffer
+    byte TxPos; //number of bytes of TxBuffer already sent
+    byte TxPart; //part of the ascii element under construction
+    uint16_t TxPartPos; //position inside the text of the part under construction
+    unsigned int TxSent; //number of bytes sent in the current update
+    int _txroom; //size of the serial tx buffer (biggest availableForWrite() seen)
+    unsigned int _txbudgetus; //tx budget of each update in microseconds
+    unsigned int _txbudgetbytes; //tx budget of each update in bytes
+    #if SERIALWATCHER_TX_DELTA
+    byte _txframe; //stream counter, a keyframe is sent when it is 0
+    #if SERIALWATCHER_TX_DYNAMIC
+    byte (*ArrayShadow)[4]; //last transmitted value: raw bytes up to 4 bytes long, otherwise 32 bit digest
+    #else
+    byte ArrayShadow[SERIALWATCHER_TX_MAX_VALUES][4]; //last transmitted value: raw bytes up to 4 bytes long, otherwise 32 bit digest
+    #endif
+    cSerialWatcherIndex DeadbandSlots[SERIALWATCHER_TX_DELTA_DEADBANDS]; //slot of each float with a deadband
+    float DeadbandValues[SERIALWATCHER_TX_DELTA_DEADBANDS]; //deadband of each float
+    byte _deadbands; //number of deadbands in use
+    #endif
+    #if SERIALWATCHER_TX_REFRESH
+    byte SERIALWATCHER_SLOT_ARRAY(ArrayRefresh); //refresh class of each slot: 0 = every stream, n = every 2^n streams, 0xFF = on change only
+    byte _txcount; //stream counter, selects the slots sent every n streams
+    #endif
+    #if SERIALWATCHER_TX_FLOATENC
+    cSerialWatcherIndex FloatEncSlots[SERIALWATCHER_TX_FLOATENC_MAX]; //slot of each float with an encoding
+    byte FloatEncTypes[SERIALWATCHER_TX_FLOATENC_MAX]; //SERIALWATCHER_DATATYPE_half or SERIALWATCHER_DATATYPE_fixed16
+    float FloatEncScales[SERIALWATCHER_TX_FLOATENC_MAX]; //fixed point: value = offset + integer * scale
+    float FloatEncOffsets[SERIALWATCHER_TX_FLOATENC_MAX];
+    byte _floatencs; //number of float encodings in use
+    #endif
+    #if SERIALWATCHER_TX_ALARM
+    cSerialWatcherIndex AlarmSlots[SERIALWATCHER_TX_ALARM_MAX]; //slot of each watched variable
+    byte AlarmConditions[SERIALWATCHER_TX_ALARM_MAX]; //SERIALWATCHER_ALARM_*
+    float AlarmLimits[SERIALWATCHER_TX_ALARM_MAX]; //limit of SERIALWATCHER_ALARM_ABOVE and SERIALWATCHER_ALARM_BELOW
+    uint32_t AlarmBits[SERIALWATCHER_TX_ALARM_MAX]; //mask of SERIALWATCHER_ALARM_MASK, last value (32 bit digest) of SERIALWATCHER_ALARM_CHANGE
+    byte _alarms; //number of watched variables
+    byte _alarmstate; //one bit for each alarm, 1 = raised
+    byte _alarmpending; //one bit for each alarm, 1 = to be sent
+    byte _alarmreport; //one bit for each alarm, state to be sent (the first edge since the last alarm sent)
+    byte _alarmheld; //one bit for each alarm, SERIALWATCHER_ALARM_CHANGE sent in this stream (the next change waits for the next stream)
+    bool _alarmturn; //an alarm was sent at the last element boundary, the next one goes to the sweep
+    #endif
+    #if SERIALWATCHER_TX_NUMARRAYS
+    cSerialWatcherIndex NumArraySlots[SERIALWATCHER_NUMARRAYS_TABLE]; //slot of each numeric array
+    uint16_t NumArrayLengths[SERIALWATCHER_NUMARRAYS_TABLE]; //number of values of each numeric array
+    byte _numarrays; //number of numeric arrays in use
+    #endif
+    #if SERIALWATCHER_TX_SNAPSHOT
+    uint64_t _snapshot[(SERIALWATCHER_TX_SNAPSHOT_BUFFER + 7) / 8]; //numeric values of the stream in progress, packed in slot order (uint64_t = aligned for any datatype)
+    cSerialWatcherIndex _snapshotend; //first slot not in the snapshot
+    cSerialWatcherIndex _snapshotslot; //read cursor: slot ...
+    uint16_t _snapshotpos; //... and the end of the values before it
+    #endif
+    #if SERIALWATCHER_TX_SCHEMA
+    byte _schemaversion; //changes whenever the mapping changes
+    byte _schemasent; //schema version of the last schema frame
+    #endif
+    #if SERIALWATCHER_SCOPE
+    cSerialWatcherIndex ScopeSlots[SERIALWATCHER_SCOPE_SLOTS]; //sampled slots
+    byte ScopeBuffer[SERIALWATCHER_SCOPE_BUFFER]; //ring buffer of samples
+    byte _scopeslots; //number of sampled slots
+    byte _scopesize; //bytes of one sample
+    byte _scopedecimation; //one sample every _scopedecimation updates (0 = scope stopped)
+    byte _scopetick; //updates since the last sample
+    uint16_t _scopecapacity; //number of samples that fit in the ring buffer
+    uint16_t _scopehead; //next sample to be written
+    uint16_t _scopetail; //next sample to be sent
+    uint16_t _scopecount; //samples waiting to be sent
+    uint16_t _scopeseq; //number of the next sample to be sent
+    uint16_t _scopelost; //samples dropped with the ring buffer full
+    uint16_t _scopeburst; //samples sent since the last stream start
+    #endif
 	
     //milliseconds when transmission started
     unsigned long _TxStartMillis;
 
     //rx memories
-    char RxBuffer[SERIALWATCHER_RX_ARRAY_LENGTH]; //char array containing serialwatcher rx data ('\0' means completely empty)
+    char RxBuffer[SERIALWATCHER_RX_ARRAY_LENGTH]; //char array containing the Value field of the rx command ('\0' terminated)
+    byte RxLen; //number of chars in RxBuffer
+    byte RxFields; //number of field separators received
+    char RxType; //DataType field
+    uint16_t RxSlot; //ArrayPlace field (0xFFFF = no digits received)
+    byte RxStatus; //error detected while receiving the command
+    #if SERIALWATCHER_RX_BATCH
+    byte RxPairs; //batch separators received in the command (0 = single write, applied at once)
+    cSerialWatcherIndex _batchslots[SERIALWATCHER_RX_BATCH_MAX]; //slots of the staged writes
+    uint64_t _batchvalues[SERIALWATCHER_RX_BATCH_MAX]; //staged values (uint64_t = aligned for any datatype)
+    byte _batchcount; //number of staged writes
+    byte _batchseq; //number of received batches
+    byte _batchresult; //result of the last batch
+    byte _batchstate; //SERIALWATCHER_RX_BATCH_IDLE, _COMMIT or _ACK
+    #endif
+    byte _rxerror; //result of the last rx command
+
+    //self profiling, mapped as read only slots (see ProfileMap())
+    #if SERIALWATCHER_PROFILE
+    uint16_t _proftxus; //Tx() time of the last Update(), microseconds
+    uint16_t _profrxus; //Rx() time of the last Update(), microseconds
+    uint16_t _profmaxus; //max Update() time of the last second, microseconds
+    uint16_t _profmaxrun; //max Update() time of the running second
+    uint16_t _profloop[SERIALWATCHER_PROFILE_BUCKETS]; //loop period histogram, halved when a bucket is full (keeps the shape of the recent loops)
+    uint32_t _proftxbytes; //bytes sent
+    uint32_t _profrxbytes; //bytes received
+    uint16_t _proffps; //streams sent in the last second
+    uint16_t _profframes; //streams sent in the running second
+    uint16_t _proferrors; //rx commands rejected
+    uint16_t _profoverflows; //rx commands longer than the rx buffer
+    uint32_t _proffree; //free ram in bytes, updated every second (0 = not available on this board)
+    unsigned long _proflast; //start of the previous Update()
+    unsigned long _profwindow; //start of the running second
+    #endif
     
   //private methods
   private:
+    template <typename T> friend struct cSerialWatcherTraits;
+    template <typename T, bool sign> friend struct cSerialWatcherIntTraits;
+    void MapSlot(const __FlashStringHelper *Name, void *Value, byte datatype, const cSerialWatcherCodec *codec, bool readonly);
+    void AlarmWatch(byte condition, float limit, uint32_t mask);
+    #if SERIALWATCHER_TX_NUMARRAYS
+    void MapArray(uint16_t length, byte max = SERIALWATCHER_TX_NUMARRAYS_MAX); //the last mapped slot is a numeric array, up to max arrays
+    uint16_t ArrayLength(cSerialWatcherIndex i); //number of values of a numeric array
+    byte RxArray(cSerialWatcherIndex i, char *Value); //write index:value,value ... , SERIALWATCHER_RX_OK or SERIALWATCHER_RX_ERROR_*
+    #endif
     bool CheckIdx(); //true=ok
+    #if SERIALWATCHER_TX_DYNAMIC
+    bool SlotGrow(); //allocate the next block of slots, true=ok
+    #endif
     bool CheckValidName(const __FlashStringHelper *Name); //true=valid
+    void CheckValue(cSerialWatcherIndex i); //update the invalid value flag
     bool IsCharValid(char in_char); //error value (not allowed character detected in the value) -> true: value is valid | false: value is invalid
-    bool IsTextValid(char *in_achar); //error value (not allowed character detected in the value) -> true: value is valid | false: value is invalid
+    bool IsTextValid(const char *in_achar); //error value (not allowed character detected in the value) -> true: value is valid | false: value is invalid
     bool IsTextValid(const __FlashStringHelper *in_flash); //error name (user inserted character not allowed) -> true: names is valid | false: name is invalid
     void Tx();
+    void TxStep();
+    bool TxFlush(); //true=all sent
+    bool TxDrained(); //true=serial tx buffer empty
+    void TxPut(char c);
+    void TxPut(const __FlashStringHelper *s);
+    bool TxAsciiElement(cSerialWatcherIndex i); //true=element completely encoded
+    const void *TxValue(cSerialWatcherIndex i); //value to be sent: from the snapshot or the mapped variable
+    #if SERIALWATCHER_TX_SNAPSHOT
+    void TxSnapshot(); //copy the numeric values of the stream
+    uint16_t SnapshotSize(cSerialWatcherIndex i); //bytes of the slot in the snapshot (0 = read when sent)
+    #endif
     void Rx();
-	void StringWrite(char *dst, const __FlashStringHelper *src);    
-    int StringPositionSingleChar(char *s_where, char c_char);
-    bool StringSearchSubString(char *s_where, const char *s_what);
-    bool StringSearchSubString(const __FlashStringHelper *s_where, const char *s_what);
-    #if defined(ARDUINO_AVR_UNO) || defined(ARDUINO_AVR_MEGA2560)
-	void print_unsigned_long_long(Stream &_serial, unsigned long long val);
-    void print_long_long(Stream &_serial, long long val);
-    long long atoll(char *src);
-    unsigned long long atoull(char *src);
-	#endif
+    byte RxParse(); //SERIALWATCHER_RX_OK or SERIALWATCHER_RX_ERROR_*
+    #if SERIALWATCHER_TX_ALARM
+    void AlarmCheck(); //check the watch conditions, the alarms that change are sent ahead of the sweep
+    void TxAlarm(); //send the first pending alarm
+    #endif
+    #if SERIALWATCHER_TX_SUBSCRIBE
+    cSerialWatcherIndex TxSubscribed(cSerialWatcherIndex i); //first subscribed slot from i on (TxSlotEnd = none)
+    byte RxSubscribe(byte op, const char *list); //<k"op"slots>, SERIALWATCHER_RX_OK or SERIALWATCHER_RX_ERROR_*
+    byte RxSubscribeMap(uint16_t first, const char *hex); //<K"first"hex>, SERIALWATCHER_RX_OK or SERIALWATCHER_RX_ERROR_*
+    #endif
+    #if SERIALWATCHER_PROFILE
+    void ProfileMap(); //map the profiling slots after the mapped variables
+    void Profile(unsigned long start, unsigned long txend); //update the profiling values at the end of Update()
+    #endif
+    #if SERIALWATCHER_RX_BATCH
+    byte RxStage(cSerialWatcherIndex i, const char *Value); //stage one write of a batch, SERIALWATCHER_RX_OK or SERIALWATCHER_RX_ERROR_*
+    void RxBatchEnd(); //end of a batch command: commit at the next Update() or acknowledge the error
+    void RxCommit(); //write the staged values
+    #endif
+    static bool ParseSigned(const char *src, int64_t min, int64_t max, int64_t &val); //true = valid and in range
+    static bool ParseUnsigned(const char *src, uint64_t max, uint64_t &val); //true = valid and in range
+    #if SERIALWATCHER_TX_DELTA
+    bool TxChanged(cSerialWatcherIndex i, bool keyframe); //true when the value has to be sent, the shadow copy is updated
+    bool TxDue(cSerialWatcherIndex i, bool keyframe); //true when the slot has to be sent in the stream in progress (delta mode and refresh classes)
+    #endif
+    #if SERIALWATCHER_TX_BINARY
+    byte TxBinaryElement(cSerialWatcherIndex i, byte type, byte *dst, byte room); //returns the payload length
+    void TxBinaryRecord(byte type, byte len);
+    #if SERIALWATCHER_TX_FLOATENC
+    byte FloatEncIndex(cSerialWatcherIndex i); //entry of the float encoding of the slot (0xFF = raw)
+    byte TxFloatEncoded(byte *dst, byte k, const void *value); //encoded value, returns the number of bytes
+    #endif
+    #if SERIALWATCHER_TX_NUMARRAYS
+    bool TxBinaryArray(cSerialWatcherIndex i); //one record with the next values of a numeric array, true=last record
+    #endif
+    #endif
+    #if SERIALWATCHER_SCOPE
+    byte ScopeStart(byte decimation, const char *list); //SERIALWATCHER_RX_OK or SERIALWATCHER_RX_ERROR_*
+    void ScopeSample(); //append one sample to the ring buffer
+    void TxScopeBurst(); //send the oldest samples in one binary record
+    #endif
+    byte StringCopy(byte *dst, const char *src, byte room); //copy without terminator, returns the number of copied chars
+    byte StringCopy(byte *dst, const __FlashStringHelper *src, byte room); //copy without terminator, returns the number of copied chars
+    static byte FormatUnsigned(char *dst, uint32_t val); //returns the number of chars
+    static byte FormatUnsigned(char *dst, uint64_t val);
+    static byte FormatSigned(char *dst, int32_t val);
+    static byte FormatSigned(char *dst, int64_t val);
+    static byte FormatFloat(char *dst, float val);
+    static byte Format8Digits(char *dst, uint32_t val);
+    static byte Format4Digits(char *dst, uint16_t val, bool pad);
+    static void Format2Digits(char *dst, byte val);
  
 };
 
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Datatype traits - datatype code and value codec of each mappable type
+// a type without traits can't be mapped (compile error)
+//
+//integers: the datatype is chosen by size and sign, so every board maps int, long, ... on their real width
+template <typename T, bool sign> struct cSerialWatcherIntTraits {
+  static const byte datatype = sizeof(T) == 1 ? (sign ? SERIALWATCHER_DATATYPE_int8_t : SERIALWATCHER_DATATYPE_uint8_t) :
+                               sizeof(T) == 2 ? (sign ? SERIALWATCHER_DATATYPE_int16_t : SERIALWATCHER_DATATYPE_uint16_t) :
+                               sizeof(T) == 4 ? (sign ? SERIALWATCHER_DATATYPE_int32_t : SERIALWATCHER_DATATYPE_uint32_t) :
+                                                (sign ? SERIALWATCHER_DATATYPE_int64_t : SERIALWATCHER_DATATYPE_uint64_t);
+  static const cSerialWatcherCodec codec;
+  static byte Format(char *dst, const void *value) {
+    T v = *(const T*)value;
+    if (sizeof(T) > 4) { //64 bit math only when needed
+      return sign ? cSerialWatcher::FormatSigned(dst, (int64_t)v) : cSerialWatcher::FormatUnsigned(dst, (uint64_t)v);
+    }
+    return sign ? cSerialWatcher::FormatSigned(dst, (int32_t)v) : cSerialWatcher::FormatUnsigned(dst, (uint32_t)v);
+  }
+  static bool Parse(const char *src, void *value) {
+    if (sign) {
+      const int64_t max = (int64_t)(((uint64_t)1 << (sizeof(T) * 8 - 1)) - 1);
+      int64_t v;
+      if (!cSerialWatcher::ParseSigned(src, -max - 1, max, v)) {
+        return false;
+      }
+      *(T*)value = (T)v;
+    }
+    else {
+      uint64_t v;
+      if (!cSerialWatcher::ParseUnsigned(src, (uint64_t)(T)~(T)0, v)) {
+        return false;
+      }
+      *(T*)value = (T)v;
+    }
+    return true;
+  }
+};
+template <typename T, bool sign> const cSerialWatcherCodec cSerialWatcherIntTraits<T, sign>::codec = { cSerialWatcherIntTraits<T, sign>::Format, cSerialWatcherIntTraits<T, sign>::Parse };
+template <> struct cSerialWatcherTraits<signed char> : cSerialWatcherIntTraits<signed char, true> {};
+template <> struct cSerialWatcherTraits<unsigned char> : cSerialWatcherIntTraits<unsigned char, false> {};
+template <> struct cSerialWatcherTraits<short> : cSerialWatcherIntTraits<short, true> {};
+template <> struct cSerialWatcherTraits<unsigned short> : cSerialWatcherIntTraits<unsigned short, false> {};
+template <> struct cSerialWatcherTraits<int> : cSerialWatcherIntTraits<int, true> {};
+template <> struct cSerialWatcherTraits<unsigned int> : cSerialWatcherIntTraits<unsigned int, false> {};
+template <> struct cSerialWatcherTraits<long> : cSerialWatcherIntTraits<long, true> {};
+template <> struct cSerialWatcherTraits<unsigned long> : cSerialWatcherIntTraits<unsigned long, false> {};
+template <> struct cSerialWatcherTraits<long long> : cSerialWatcherIntTraits<long long, true> {};
+template <> struct cSerialWatcherTraits<unsigned long long> : cSerialWatcherIntTraits<unsigned long long, false> {};
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+template <> struct cSerialWatcherTraits<bool> {
+  static const byte datatype = SERIALWATCHER_DATATYPE_bool;
+  static const cSerialWatcherCodec codec; //defined in cSerialWatcher.cpp
+  static byte Format(char *dst, const void *value) {
+    dst[0] = *(const bool*)value ? '1' : '0';
+    return 1;
+  }
+  static bool Parse(const char *src, void *value) {
+    *(bool*)value = (src[0] == '1');
+    return true;
+  }
+};
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+template <> struct cSerialWatcherTraits<float> {
+  static const byte datatype = SERIALWATCHER_DATATYPE_float;
+  static const cSerialWatcherCodec codec; //defined in cSerialWatcher.cpp
+  static byte Format(char *dst, const void *value) {
+    return cSerialWatcher::FormatFloat(dst, *(const float*)value);
+  }
+  static bool Parse(const char *src, void *value) {
+    char *end;
+    double f = strtod(src, &end);
+    if (end == src || *end != '\0' || !(f >= -FLT_MAX && f <= FLT_MAX)) { //empty, not a number, infinite, nan or beyond the float range
+      return false;
+    }
+    *(float*)value = f;
+    return true;
+  }
+};
+//-------------------------------------------------------------------------------------------------------------------------------------------------------------
+template <> struct cSerialWatcherTraits<char> {
+  static const byte datatype = SERIALWATCHER_DATATYPE_char;
+  static const cSerialWatcherCodec codec; //defined in cSerialWatcher.cpp
+  static byte Format(char *dst, const void *value) {
+    dst[0] = *(const char*)value;
+    return 1;
+  }
+  static bool Parse(const char *src, void *value) {
+    *(char*)value = src[0];
+    return true;
+  }
+};
+
 #endif